@@ -0,0 +1,75 @@
+/**
+ * @file avl.h
+ * @author haydenlauritzen@gmail.com
+ * @brief AVL rotations shared by the height-balanced trees
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2022
+ */
+
+#pragma once
+
+/**
+ * @brief Rotations and rebalancing for any tree that balances by subtree height.
+ * @details
+ * A tree describes its nodes with 'Ops', which provides:
+ *      left(link), right(link): references to a node's child links
+ *      height(link): levels in the subtree, 0 for an empty link
+ *      update(link): recomputes the node's cached height, and anything else it caches, from its children
+ * A link is whatever refers to a node, such as a pointer or an index. Rotations replace a subtree's
+ * root, so every function rewrites the link it is given.
+ */
+namespace avl {
+
+    template<class Ops, class Link>
+    void rotateLeft(const Ops& ops, Link& cur) {
+        /*
+         *  cur              pivot
+         *     \             /
+         *    pivot  -->   cur
+         *    /              \
+         *   x                x
+         */
+        Link pivot = ops.right(cur);
+        ops.right(cur) = ops.left(pivot);
+        ops.left(pivot) = cur;
+        ops.update(cur);
+        ops.update(pivot);
+        cur = pivot;
+    }
+
+    template<class Ops, class Link>
+    void rotateRight(const Ops& ops, Link& cur) {
+        // Mirror of rotateLeft()
+        Link pivot = ops.left(cur);
+        ops.left(cur) = ops.right(pivot);
+        ops.right(pivot) = cur;
+        ops.update(cur);
+        ops.update(pivot);
+        cur = pivot;
+    }
+
+    /**
+     * @brief Restores the AVL invariant at 'cur', whose subtrees are already balanced.
+     * @details The node is updated even if no rotation is needed.
+     */
+    template<class Ops, class Link>
+    void rebalance(const Ops& ops, Link& cur) {
+        int skew = ops.height(ops.left(cur)) - ops.height(ops.right(cur));
+        if(skew > 1) { // Left heavy
+            // Left-Right case is reduced to Left-Left
+            Link& left = ops.left(cur);
+            if(ops.height(ops.left(left)) < ops.height(ops.right(left))) rotateLeft(ops, left);
+            rotateRight(ops, cur);
+        }
+        else if(skew < -1) { // Right heavy
+            // Right-Left case is reduced to Right-Right
+            Link& right = ops.right(cur);
+            if(ops.height(ops.right(right)) < ops.height(ops.left(right))) rotateRight(ops, right);
+            rotateLeft(ops, cur);
+        }
+        else {
+            ops.update(cur);
+        }
+    }
+
+}
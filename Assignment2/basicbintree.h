@@ -0,0 +1,233 @@
+/**
+ * @file basicbintree.h
+ * @author haydenlauritzen@gmail.com
+ * @brief Header file for BasicBinTree
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2022
+ */
+
+#pragma once
+
+#include"avl.h"
+#include<cstdint>
+#include<functional>
+#include<iostream>
+#include<utility>
+#include<vector>
+
+/**
+ * @brief AVL tree of keys stored inline in its nodes, ordered by 'Compare'.
+ * @details
+ * BinTree stores NodeData behind a pointer and owns it, which suits strings read from a file.
+ * BasicBinTree is for small value keys such as integers or fixed-size records: each key is
+ * kept inside its node, nodes live in one vector and refer to each other by index, so a tree
+ * makes no per-key allocations and a lookup never leaves the node array.
+ * Keys are compared only through 'Compare', two keys are equal if neither is less.
+ * @tparam Key Copyable or movable key type.
+ * @tparam Compare Strict weak ordering on Key.
+ */
+template<class Key, class Compare = std::less<Key>>
+class BasicBinTree {
+
+    /**
+     * @brief Prints the keys in sorted order.
+     * @return ostream&
+     */
+    friend std::ostream& operator<<(std::ostream& os, const BasicBinTree& tree) {
+        bool first = true;
+        tree.forEach([&](const Key& key) {
+            if(!first) {
+                os << " ";
+            }
+            else {
+                first = false;
+            }
+            os << key;
+        });
+        os << std::endl;
+        return os;
+    }
+
+private:
+
+    using Index = uint32_t;
+    static const Index NIL = UINT32_MAX; // Index of a missing child
+
+    struct Node {
+        Key key;
+        Index left, right;
+        int height; // Levels in the subtree rooted here, a leaf is 1
+    };
+
+    std::vector<Node> nodes;
+    Index root;
+    Compare less;
+
+    /* AVL Helpers */
+
+    int height(Index cur) const {
+        return cur == NIL ? 0 : this->nodes[cur].height;
+    }
+
+    void updateHeight(Index cur) {
+        int left = this->height(this->nodes[cur].left);
+        int right = this->height(this->nodes[cur].right);
+        this->nodes[cur].height = 1 + (left > right ? left : right);
+    }
+
+    // Describes index links to the rotations in avl.h
+    struct Links {
+        BasicBinTree& tree;
+        Index& left(Index cur) const { return tree.nodes[cur].left; }
+        Index& right(Index cur) const { return tree.nodes[cur].right; }
+        int height(Index cur) const { return tree.height(cur); }
+        void update(Index cur) const { tree.updateHeight(cur); }
+    };
+
+    /**
+     * @brief Returns the link to a child of 'parent', or the root link for NIL.
+     */
+    Index& link(Index parent, bool right) {
+        if(parent == NIL) return this->root;
+        return right ? this->nodes[parent].right : this->nodes[parent].left;
+    }
+
+public:
+
+    /* Constructors */
+    /**
+     * @brief Creates an empty tree.
+     * @param compare Ordering of the keys.
+     */
+    explicit BasicBinTree(const Compare& compare = Compare()) : root(NIL), less(compare) {}
+
+    /* Accessors */
+
+    /**
+     * @brief Finds the stored key equal to 'key'.
+     * @return nullptr If the key is not in the tree.
+     * @note The pointer is invalidated by the next insert.
+     */
+    const Key* find(const Key& key) const {
+        Index cur = this->root;
+        while(cur != NIL) {
+            const Node& node = this->nodes[cur];
+            if(this->less(key, node.key)) {
+                cur = node.left;
+            }
+            else if(this->less(node.key, key)) {
+                cur = node.right;
+            }
+            else {
+                return &node.key;
+            }
+        }
+        return nullptr;
+    }
+    /**
+     * @brief Determines if a key is in the tree.
+     */
+    bool contains(const Key& key) const {
+        return this->find(key) != nullptr;
+    }
+    /**
+     * @brief Returns the number of keys in the tree.
+     */
+    size_t size() const {
+        return this->nodes.size();
+    }
+    /**
+     * @brief Determines if the tree is empty.
+     */
+    bool isEmpty() const {
+        return this->nodes.empty();
+    }
+    /**
+     * @brief Returns the number of levels in the tree, 0 if empty.
+     */
+    int getHeight() const {
+        return this->height(this->root);
+    }
+    /**
+     * @brief Calls f(key) on every key in sorted order.
+     */
+    template<class F>
+    void forEach(F&& f) const {
+        std::vector<Index> stack;
+        stack.reserve(this->getHeight());
+        Index cur = this->root;
+        while(cur != NIL || !stack.empty()) {
+            while(cur != NIL) {
+                stack.push_back(cur);
+                cur = this->nodes[cur].left;
+            }
+            cur = stack.back();
+            stack.pop_back();
+            f(this->nodes[cur].key);
+            cur = this->nodes[cur].right;
+        }
+    }
+    /**
+     * @brief Copies the keys into a vector in sorted order, the tree is not modified.
+     */
+    void toVector(std::vector<Key>& keys) const {
+        keys.clear();
+        keys.reserve(this->size());
+        this->forEach([&keys](const Key& key) { keys.push_back(key); });
+    }
+
+    /* Mutators */
+
+    /**
+     * @brief Inserts a key, the tree is rebalanced on the way back up.
+     * @return true If the key was inserted.
+     * @return false If an equal key is already in the tree.
+     */
+    bool insert(Key key) {
+        // Links followed from the root, each as the parent and the side of the child
+        std::vector<std::pair<Index, bool>> path;
+        path.reserve(this->getHeight());
+        Index parent = NIL;
+        bool right = false;
+        for(Index cur = this->root; cur != NIL; ) {
+            path.emplace_back(parent, right);
+            const Node& node = this->nodes[cur];
+            if(this->less(key, node.key)) {
+                right = false;
+            }
+            else if(this->less(node.key, key)) {
+                right = true;
+            }
+            else {
+                return false;
+            }
+            parent = cur;
+            cur = right ? node.right : node.left;
+        }
+        Index added = static_cast<Index>(this->nodes.size());
+        this->nodes.push_back(Node{std::move(key), NIL, NIL, 1});
+        this->link(parent, right) = added;
+        // Rotations replace a subtree's root, so each node is rebalanced through its link
+        while(!path.empty()) {
+            auto [above, side] = path.back();
+            path.pop_back();
+            avl::rebalance(Links{*this}, this->link(above, side));
+        }
+        return true;
+    }
+    /**
+     * @brief Reserves node storage for 'count' keys.
+     */
+    void reserve(size_t count) {
+        this->nodes.reserve(count);
+    }
+    /**
+     * @brief Empties the tree.
+     * @post isEmpty() == true
+     */
+    void makeEmpty() {
+        this->nodes.clear();
+        this->root = NIL;
+    }
+
+};
@@ -0,0 +1,335 @@
+/**
+ * @file bench.cpp
+ * @author haydenlauritzen@gmail.com
+ * @brief Benchmarks the ordered containers against each other, results are written as CSV
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2022
+ */
+
+#include"bintree.h"
+#include"btree.h"
+#include"concurrentbintree.h"
+#include"radixtree.h"
+#include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<cmath>
+#include<cstdlib>
+#include<mutex>
+#include<random>
+#include<string>
+#include<thread>
+#include<vector>
+
+using namespace std;
+
+/**
+ * @brief Generates 'count' random lowercase words of 8 to 12 letters.
+ */
+vector<string> randomWords(size_t count, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> length(8, 12), letter('a', 'z');
+    vector<string> words(count);
+    for(string& word : words) {
+        word.resize(length(rng));
+        for(char& c : word) c = static_cast<char>(letter(rng));
+    }
+    return words;
+}
+
+/**
+ * @brief Generates 'count' words built from a small set of stems, like the tokens in data2.txt.
+ * @details Words share long prefixes and repeat often, the case a trie compresses best.
+ */
+vector<string> prefixWords(size_t count, unsigned seed) {
+    mt19937 rng(seed);
+    // Stems do not depend on 'seed', so probes drawn with another seed hit the same prefixes
+    vector<string> stems = randomWords(256, 0);
+    uniform_int_distribution<size_t> stem(0, stems.size() - 1);
+    uniform_int_distribution<int> length(0, 4), letter('a', 'z');
+    vector<string> words(count);
+    for(string& word : words) {
+        word = stems[stem(rng)];
+        for(int i = length(rng); i > 0; i--) word += static_cast<char>(letter(rng));
+    }
+    return words;
+}
+
+/**
+ * @brief Generates 'count' draws from a vocabulary of count / 10 words with Zipf(1) frequencies.
+ * @details The most common word makes up about a tenth of the draws, most words are rare.
+ */
+vector<string> zipfWords(size_t count, unsigned seed) {
+    vector<string> vocabulary = randomWords(count / 10 + 1, 0);
+    // Cumulative weights of rank r ~ 1 / r
+    vector<double> cumulative(vocabulary.size());
+    double total = 0;
+    for(size_t r = 0; r < vocabulary.size(); r++) {
+        total += 1.0 / static_cast<double>(r + 1);
+        cumulative[r] = total;
+    }
+    mt19937 rng(seed);
+    uniform_real_distribution<double> draw(0, total);
+    vector<string> words(count);
+    for(string& word : words) {
+        size_t rank = lower_bound(cumulative.begin(), cumulative.end(), draw(rng)) - cumulative.begin();
+        word = vocabulary[min(rank, vocabulary.size() - 1)];
+    }
+    return words;
+}
+
+/**
+ * @brief Generates a named workload of 'count' words.
+ * @param kind random, sorted, reverse, zipf or prefixed.
+ * @return Empty if 'kind' is not a known workload.
+ */
+vector<string> makeWorkload(const string& kind, size_t count, unsigned seed) {
+    if(kind == "random") return randomWords(count, seed);
+    if(kind == "zipf") return zipfWords(count, seed);
+    if(kind == "prefixed") return prefixWords(count, seed);
+    vector<string> words = randomWords(count, seed);
+    if(kind == "sorted") {
+        sort(words.begin(), words.end());
+        return words;
+    }
+    if(kind == "reverse") {
+        sort(words.rbegin(), words.rend());
+        return words;
+    }
+    return {};
+}
+
+/**
+ * @brief Times 'f' in milliseconds.
+ */
+template<class F>
+double timeMs(F&& f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Inserts every key, looks up every probe, then dumps the tree to a vector.
+ * @details Works with any container exposing insert(), retrieve() and bstreeToArray().
+ */
+template<class Tree>
+void benchTree(const string& workload, const string& name, Tree& tree, const vector<string>& keys, const vector<string>& probes) {
+    size_t found = 0;
+    double insertMs = timeMs([&] {
+        for(const string& key : keys) {
+            NodeData* nd = new NodeData(key);
+            if(!tree.insert(nd)) delete nd;
+        }
+    });
+    vector<NodeData> lookups(probes.begin(), probes.end());
+    double retrieveMs = timeMs([&] {
+        NodeData* out;
+        for(const NodeData& nd : lookups) {
+            found += tree.retrieve(nd, out);
+        }
+    });
+    vector<NodeData*> values;
+    double dumpMs = timeMs([&] { tree.bstreeToArray(values); });
+    for(NodeData* nd : values) delete nd;
+    cout << workload << "," << name << "," << keys.size() << "," << insertMs << "," << retrieveMs << "," << dumpMs << "," << found << endl;
+}
+
+/**
+ * @brief Stress tests concurrent lookups while one writer inserts.
+ * @details
+ * The first half of 'keys' is loaded before the readers start and must always be found,
+ * the writer then inserts the second half. Lookups per second are reported for each reader count,
+ * for ConcurrentBinTree and for a BinTree behind a global mutex.
+ */
+void benchConcurrent(const vector<string>& keys) {
+    size_t half = keys.size() / 2;
+    vector<NodeData> probes(keys.begin(), keys.begin() + half);
+    cout << "tree,readers,lookups_per_sec,writer_ms,errors" << endl;
+    for(int readers : {1, 2, 4, 8}) {
+        ConcurrentBinTree lockFree;
+        BinTree locked(BinTree::Balance::AVL);
+        mutex lock;
+        for(size_t i = 0; i < half; i++) {
+            NodeData* nd = new NodeData(keys[i]);
+            if(!lockFree.insert(nd)) delete nd;
+            nd = new NodeData(keys[i]);
+            if(!locked.insert(nd)) delete nd;
+        }
+        auto run = [&](const string& name, auto&& insert, auto&& retrieve) {
+            atomic<bool> done{false};
+            atomic<size_t> lookups{0}, errors{0};
+            vector<thread> threads;
+            auto start = chrono::steady_clock::now();
+            for(int r = 0; r < readers; r++) {
+                threads.emplace_back([&, r] {
+                    size_t local = 0, i = r * 7919;
+                    while(!done.load(memory_order_relaxed)) {
+                        const NodeData& probe = probes[i++ % probes.size()];
+                        NodeData* out = nullptr;
+                        if(!retrieve(probe, out) || *out != probe) errors++;
+                        local++;
+                    }
+                    lookups += local;
+                });
+            }
+            double writerMs = timeMs([&] {
+                for(size_t i = half; i < keys.size(); i++) {
+                    NodeData* nd = new NodeData(keys[i]);
+                    if(!insert(nd)) delete nd;
+                }
+            });
+            done = true;
+            for(thread& t : threads) t.join();
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            cout << name << "," << readers << "," << lookups / seconds << "," << writerMs << "," << errors << endl;
+        };
+        run("ConcurrentBinTree",
+            [&](NodeData* nd) { return lockFree.insert(nd); },
+            [&](const NodeData& nd, NodeData*& out) { return lockFree.retrieve(nd, out); });
+        run("BinTree+mutex",
+            [&](NodeData* nd) { lock_guard<mutex> guard(lock); return locked.insert(nd); },
+            [&](const NodeData& nd, NodeData*& out) { lock_guard<mutex> guard(lock); return locked.retrieve(nd, out); });
+        // Every key inserted by the writer must be visible afterwards
+        size_t missing = 0;
+        for(const string& key : keys) {
+            NodeData* out;
+            if(!lockFree.retrieve(NodeData(key), out)) missing++;
+        }
+        if(missing != 0 || lockFree.size() != locked.size()) {
+            cout << "ConcurrentBinTree lost " << missing << " keys" << endl;
+        }
+    }
+}
+
+/**
+ * @brief Times each BinTree operation on one workload and writes a CSV row per operation.
+ * @details
+ * Probes are every key in shuffled order plus as many absent words. 'check' is what the
+ * operation produced (values inserted or found, summed heights, equality, size), so a wrong
+ * result shows up next to its time.
+ */
+void benchOperations(const string& workload, const vector<string>& keys, BinTree::Balance balance) {
+    string name = balance == BinTree::Balance::AVL ? "BinTree(AVL)" : "BinTree";
+    auto row = [&](const string& operation, double ms, size_t check) {
+        cout << workload << "," << name << "," << keys.size() << "," << operation << "," << ms << "," << check << endl;
+    };
+    vector<NodeData> probes(keys.begin(), keys.end());
+    for(const string& word : randomWords(keys.size(), 7)) {
+        probes.emplace_back(word + "#"); // '#' never appears in generated words
+    }
+    shuffle(probes.begin(), probes.end(), mt19937(8));
+
+    BinTree tree(balance), twin(balance);
+    double ms;
+    size_t inserted = 0;
+    ms = timeMs([&] {
+        for(const string& key : keys) {
+            NodeData* nd = new NodeData(key);
+            if(tree.insert(nd)) {
+                inserted++;
+            }
+            else {
+                delete nd;
+            }
+        }
+    });
+    row("insert", ms, inserted);
+    for(const string& key : keys) {
+        twin.emplace(key);
+    }
+    size_t found = 0;
+    ms = timeMs([&] {
+        NodeData* out;
+        for(const NodeData& nd : probes) found += tree.retrieve(nd, out);
+    });
+    row("retrieve", ms, found);
+    size_t heights = 0;
+    ms = timeMs([&] {
+        for(const NodeData& nd : probes) heights += tree.getHeight(nd);
+    });
+    row("getHeight", ms, heights);
+    // Trees built separately share no nodes, so every node is compared
+    bool equal = false;
+    ms = timeMs([&] { equal = tree == twin; });
+    row("operator==", ms, equal);
+    BinTree copy;
+    ms = timeMs([&] { copy = tree; });
+    row("copy", ms, copy.size());
+    vector<NodeData*> values;
+    ms = timeMs([&] { tree.bstreeToArray(values); });
+    row("bstreeToArray", ms, values.size());
+    ms = timeMs([&] { tree.arrayToBSTree(values); });
+    row("arrayToBSTree", ms, tree.size());
+}
+
+int main(int argc, char* argv[]) {
+    // Bench.out [suite] [keys], suite is containers, concurrent, operations or all
+    string suite = argc > 1 ? argv[1] : "all";
+    size_t count = argc > 2 ? strtoul(argv[2], nullptr, 10) : 0;
+    bool all = suite == "all";
+    if(!all && suite != "containers" && suite != "concurrent" && suite != "operations") {
+        cerr << "usage: " << argv[0] << " [containers|concurrent|operations|all] [keys]" << endl;
+        return 1;
+    }
+
+    if(all || suite == "operations") {
+        // Unbalanced trees are quadratic on sorted input, so the default size is smaller
+        size_t opCount = count > 0 ? count : 20000;
+        cout << "workload,tree,keys,operation,ms,check" << endl;
+        for(const char* kind : { "random", "sorted", "reverse", "zipf", "prefixed" }) {
+            vector<string> keys = makeWorkload(kind, opCount, 1);
+            benchOperations(kind, keys, BinTree::Balance::None);
+            benchOperations(kind, keys, BinTree::Balance::AVL);
+        }
+        cout << endl;
+    }
+
+    if(count == 0) count = 1000000;
+    vector<string> keys = randomWords(count, 1);
+    if(all || suite == "containers") {
+        // Half of the probes are present in the tree
+        vector<string> probes = randomWords(count / 2, 2);
+        probes.insert(probes.end(), keys.begin(), keys.begin() + count / 2);
+        shuffle(probes.begin(), probes.end(), mt19937(3));
+
+        cout << "workload,tree,keys,insert_ms,retrieve_ms,dump_ms,found" << endl;
+        {
+            BinTree tree;
+            benchTree("random", "BinTree", tree, keys, probes);
+        }
+        {
+            BinTree tree(BinTree::Balance::AVL);
+            benchTree("random", "BinTree(AVL)", tree, keys, probes);
+        }
+        {
+            BTree tree;
+            benchTree("random", "BTree", tree, keys, probes);
+        }
+        {
+            RadixTree tree;
+            benchTree("random", "RadixTree", tree, keys, probes);
+        }
+        // Shared prefixes and duplicates, probes are a different draw from the same stems
+        vector<string> prefixed = prefixWords(count, 4);
+        vector<string> prefixedProbes = prefixWords(count, 5);
+        {
+            BinTree tree(BinTree::Balance::AVL);
+            benchTree("prefixed", "BinTree(AVL)", tree, prefixed, prefixedProbes);
+        }
+        {
+            BTree tree;
+            benchTree("prefixed", "BTree", tree, prefixed, prefixedProbes);
+        }
+        {
+            RadixTree tree;
+            benchTree("prefixed", "RadixTree", tree, prefixed, prefixedProbes);
+        }
+        cout << endl;
+    }
+
+    if(all || suite == "concurrent") {
+        benchConcurrent(keys);
+    }
+    return 0;
+}
@@ -0,0 +1 @@
+g++ nodedata.cpp bintree.cpp btree.cpp concurrentbintree.cpp radixtree.cpp bench.cpp -O2 -std=c++17 -pthread -o Bench.out && ./Bench.out && rm Bench.out
\ No newline at end of file
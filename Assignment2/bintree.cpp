@@ -7,18 +7,131 @@
  */
 
 #include"bintree.h"
+#include"avl.h"
+#include<algorithm>
+#include<cstring>
+#include<fstream>
+#include<thread>
+#include<unordered_map>
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+namespace {
+
+    // Trees and ranges smaller than this are processed on the calling thread
+    const size_t PARALLEL_CUTOFF = 1 << 14;
+
+    /**
+     * Splits [0, count) into 'threads' contiguous ranges and runs f(begin, end) on each,
+     * the first range on the calling thread.
+     */
+    template<class F>
+    void parallelFor(size_t count, unsigned threads, F&& f) {
+        size_t chunk = (count + threads - 1) / (threads == 0 ? 1 : threads);
+        if(threads <= 1 || chunk == 0 || chunk >= count) {
+            f(size_t(0), count);
+            return;
+        }
+        std::vector<std::thread> workers;
+        for(size_t begin = chunk; begin < count; begin += chunk) {
+            workers.emplace_back([&f, begin, end = std::min(count, begin + chunk)] { f(begin, end); });
+        }
+        f(size_t(0), chunk);
+        for(std::thread& worker : workers) worker.join();
+    }
+
+    // Rendered output is handed to the stream in chunks of about this size
+    const size_t RENDER_CHUNK = 1 << 16;
+
+    /**
+     * Writes 'buffer' to 'os' once it holds at least 'threshold' bytes, then clears it.
+     */
+    void flushBuffer(std::ostream& os, std::string& buffer, size_t threshold) {
+        if(buffer.size() < threshold || buffer.empty()) return;
+        os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    /**
+     * Sorts 'threads' ranges of 'nd' in parallel, then merges neighbouring ranges in rounds.
+     */
+    void parallelSort(std::vector<NodeData*>& nd, unsigned threads) {
+        auto less = [](const NodeData* lhs, const NodeData* rhs) { return *lhs < *rhs; };
+        if(threads <= 1 || nd.size() < PARALLEL_CUTOFF) {
+            std::sort(nd.begin(), nd.end(), less);
+            return;
+        }
+        std::vector<size_t> bounds;
+        for(unsigned i = 0; i <= threads; i++) {
+            bounds.push_back(nd.size() * i / threads);
+        }
+        parallelFor(threads, threads, [&](size_t begin, size_t end) {
+            for(size_t i = begin; i < end; i++) {
+                std::sort(nd.begin() + bounds[i], nd.begin() + bounds[i+1], less);
+            }
+        });
+        while(bounds.size() > 2) {
+            // Ranges are merged pairwise, an odd range out is carried to the next round
+            std::vector<size_t> next;
+            std::vector<std::thread> workers;
+            size_t i = 0;
+            for(; i + 2 < bounds.size(); i += 2) {
+                workers.emplace_back([&nd, &less, lo = bounds[i], mid = bounds[i+1], hi = bounds[i+2]] {
+                    std::inplace_merge(nd.begin() + lo, nd.begin() + mid, nd.begin() + hi, less);
+                });
+                next.push_back(bounds[i]);
+            }
+            if(i < bounds.size() - 1) next.push_back(bounds[i]);
+            next.push_back(bounds.back());
+            for(std::thread& worker : workers) worker.join();
+            bounds = std::move(next);
+        }
+    }
+
+}
 
 /*** Constructors ***/
 
 BinTree::BinTree() {
     this->root = nullptr;
+    this->nodeCount = 0;
+    this->balance = Balance::None;
+    this->ordered = true;
+    this->counting = false;
+    this->threads = 1;
 }    
 
+BinTree::BinTree(Balance balance) {
+    this->root = nullptr;
+    this->nodeCount = 0;
+    this->balance = balance;
+    this->ordered = true;
+    this->counting = false;
+    this->threads = 1;
+}
+
 BinTree::BinTree(const BinTree& bst) {
     this->root = nullptr;
+    this->nodeCount = 0;
+    this->balance = bst.balance;
+    this->ordered = true;
+    this->counting = bst.counting;
+    this->threads = bst.threads;
     this->operator=(bst);  
 }   
 
+BinTree::BinTree(BinTree&& bst) noexcept {
+    this->root = nullptr;
+    this->nodeCount = 0;
+    this->balance = bst.balance;
+    this->ordered = true;
+    this->counting = bst.counting;
+    this->threads = bst.threads;
+    this->operator=(std::move(bst));
+}   
+
 BinTree::~BinTree() {
     this->makeEmpty();
 }
@@ -26,39 +139,62 @@ BinTree::~BinTree() {
 /* Overloaded Operators */
 
 BinTree& BinTree::operator=(const BinTree& bst) {
-    if(*this == bst) return *this;
+    if(this == &bst) return *this;
     // If tree is empty, makeEmpty() will immediately return.
     this->makeEmpty();
-    auto h_assign = [this](const BinNode* rhs, auto&& h_assign) {
-        if(rhs == nullptr) return; // Base Case
-        NodeData* newData = new NodeData(*(rhs->data));
-        this->insert(newData);
-        h_assign(rhs->left, h_assign);
-        h_assign(rhs->right, h_assign);
-    };
-    // Begin recursion.
-    h_assign(bst.root, h_assign);
+    this->balance = bst.balance;
+    this->ordered = bst.ordered;
+    this->counting = bst.counting;
+    this->threads = bst.threads;
+    if(bst.root == nullptr) return *this;
+    // Shape is duplicated directly, so no comparisons or rotations are needed
+    this->pool = std::make_shared<NodePool>();
+    this->root = clone(bst.root, bst.nodeCount, *this->pool, this->threads);
+    this->nodeCount = bst.nodeCount;
+    return *this;
+}
+
+BinTree& BinTree::operator=(BinTree&& bst) noexcept {
+    if(this == &bst) return *this;
+    this->makeEmpty();
+    this->balance = bst.balance;
+    this->ordered = bst.ordered;
+    this->counting = bst.counting;
+    this->threads = bst.threads;
+    this->root = bst.root;
+    this->nodeCount = bst.nodeCount;
+    this->pool = std::move(bst.pool);
+    bst.root = nullptr;
+    bst.nodeCount = 0;
+    bst.ordered = true;
     return *this;
 }
 
 bool BinTree::operator==(const BinTree& bst) const {
-    bool equal = true;
-    auto h_equivalence = [&](const BinNode* lhs, const BinNode* rhs, auto&& h_equivalence) -> void {
-        if(lhs == nullptr || rhs == nullptr) { // Base Case
+    // Fast rejects, equal trees have equal sizes and root hashes
+    if(this->nodeCount != bst.nodeCount || hash(this->root) != hash(bst.root)) return false;
+    // Copy-on-write copies may share the same nodes
+    if(this->root == bst.root) return true;
+    // Pairs of nodes at the same position in both trees
+    std::vector<std::pair<const BinNode*, const BinNode*>> stack;
+    stack.emplace_back(this->root, bst.root);
+    while(!stack.empty()) {
+        auto [lhs, rhs] = stack.back();
+        stack.pop_back();
+        if(lhs == nullptr || rhs == nullptr) {
             // If only one Node is a nullptr, the BSTs are not equivalent
             // If both nodes are nullptr, we have reached a leaf node's branches.
-            if(lhs != rhs) equal = false;
+            if(lhs != rhs) return false;
         }
-        else if(*(lhs->data) != *(rhs->data)) { 
-            equal = false;
+        else if(*(lhs->data) != *(rhs->data) || lhs->extra != rhs->extra) { 
+            return false;
         }
         else {
-            h_equivalence(lhs->left, rhs->left, h_equivalence);
-            h_equivalence(lhs->right, rhs->right, h_equivalence);
+            stack.emplace_back(lhs->right, rhs->right);
+            stack.emplace_back(lhs->left, rhs->left);
         }
-    };
-    h_equivalence(this->root, bst.root, h_equivalence);
-    return equal;
+    }
+    return true;
 }
 
 bool BinTree::operator!=(const BinTree& bst) const {
@@ -79,164 +215,458 @@ bool BinTree::retrieve(const NodeData& nd, NodeData*& out) {
 /* Mutators */
 
 bool BinTree::insert(NodeData* nd) {
-    auto h_insert = [&](BinNode*& cur, auto&& h_insert) mutable {
-        if(cur == nullptr) {
-            cur = new BinNode();
-            cur->data = nd;
-            return true;
+    return this->insertNode(nd);
+}
+
+bool BinTree::insertNode(NodeData* nd) {
+    // Links followed from the root, rotations rewrite the link to a subtree
+    std::vector<BinNode**> path;
+    BinNode** link = this->findLink(nd->view(), path);
+    // Otherwise node is a duplicate, it is counted or rejected
+    if(link == nullptr) {
+        if(!this->counting) return false;
+        delete nd;
+        return true;
+    }
+    this->linkNode(link, path, nd);
+    return true;
+}
+
+BinTree::BinNode** BinTree::descend(std::string_view key, std::vector<BinNode**>& path) {
+    path.reserve(height(this->root));
+    // Most nodes are told apart by their 8-byte prefix alone
+    uint64_t prefix = NodeData::prefixOf(key);
+    BinNode** link = &this->root;
+    while(*link != nullptr) {
+        BinNode* cur = *link;
+        path.push_back(link);
+        BINTREE_STAT(++this->counters.insertComparisons);
+        int cmp = cur->data->compare(key, prefix);
+        // Key is larger -> go right
+        if(cmp < 0) {
+            link = &cur->right;
         }
-        // Data to insert is larger -> go right
-        else if(*nd > *(cur->data)) {
-            return h_insert(cur->right, h_insert);
+        // Key is smaller -> go left
+        else if(cmp > 0) {
+            link = &cur->left;
         }
-        // Data to insert is smaller -> go left
-        else if(*nd < *(cur->data)) {
-            return h_insert(cur->left, h_insert);
+        else {
+            break;
         }
-        // Otherwise node is a duplicate, function will return
-        return false;
-    };
-    return h_insert(this->root, h_insert);
+    }
+    return link;
+}
+
+BinTree::BinNode** BinTree::findLink(std::string_view key, std::vector<BinNode**>& path) {
+    BINTREE_STAT(++this->counters.inserts);
+    BinNode** link = this->descend(key, path);
+    // An uncounted duplicate changes nothing, a shared tree is left shared
+    if(*link != nullptr && !this->counting) return nullptr;
+    if(this->pool == nullptr || this->isShared()) {
+        // Cloning moves every node, so the descent is repeated in the private copy
+        // The copy has the same shape, its comparisons were already counted by the first descent
+        BINTREE_STAT(uint64_t comparisons = this->counters.insertComparisons);
+        this->detach();
+        path.clear();
+        link = this->descend(key, path);
+        BINTREE_STAT(this->counters.insertComparisons = comparisons);
+    }
+    if(*link != nullptr) {
+        ++(*link)->extra;
+        return nullptr;
+    }
+    return link;
+}
+
+void BinTree::linkNode(BinNode** link, std::vector<BinNode**>& path, NodeData* nd) {
+    *link = this->pool->allocate();
+    (*link)->data = nd;
+    BinTree::updateNode(*link);
+    ++this->nodeCount;
+    // Heights and hashes along the insertion path have changed
+    bool rebalance = this->balance == Balance::AVL;
+    while(!path.empty()) {
+        BinNode*& cur = *path.back();
+        path.pop_back();
+        rebalance ? BinTree::rebalance(cur) : BinTree::updateNode(cur);
+    }
+}
+
+bool BinTree::remove(const NodeData& nd) {
+    std::vector<BinNode*> path;
+    // A missing value changes nothing, a shared tree is left shared
+    if(!this->findPath(nd, path)) return false;
+    if(this->isShared()) {
+        // Cloning moves every node, so the search is repeated in the private copy
+        this->detach();
+        path.clear();
+        this->findPath(nd, path);
+    }
+    if(path.back()->extra > 0) {
+        // Counted duplicates are removed one occurrence at a time
+        --path.back()->extra;
+        return true;
+    }
+    this->removeNode(path);
+    return true;
+}
+
+bool BinTree::findPath(const NodeData& nd, std::vector<BinNode*>& path) const {
+    if(this->root == nullptr) return false;
+    if(this->ordered) {
+        for(BinNode* cur = this->root; cur != nullptr; ) {
+            path.push_back(cur);
+            if(nd < *(cur->data)) {
+                cur = cur->left;
+            }
+            else if(nd > *(cur->data)) {
+                cur = cur->right;
+            }
+            else {
+                break;
+            }
+        }
+        return *(path.back()->data) == nd;
+    }
+    // Tree is not a BST, scan in order and reuse the iterator's path
+    Iterator it = this->begin();
+    while(it != this->end() && *it != nd) ++it;
+    if(it == this->end()) return false;
+    for(const BinNode* cur : it.path) {
+        path.push_back(const_cast<BinNode*>(cur));
+    }
+    return true;
+}
+
+size_t BinTree::remove(const std::vector<NodeData>& values) {
+    size_t removed = 0;
+    for(const NodeData& nd : values) {
+        if(this->remove(nd)) ++removed;
+    }
+    return removed;
+}
+
+void BinTree::removeNode(std::vector<BinNode*>& path) {
+    BinNode* target = path.back();
+    delete target->data;
+    if(target->left != nullptr && target->right != nullptr) {
+        // Successor is the leftmost node of the right subtree, it has no left child
+        for(BinNode* cur = target->right; cur != nullptr; cur = cur->left) {
+            path.push_back(cur);
+        }
+        target->data = path.back()->data;
+        target->extra = path.back()->extra;
+    }
+    BinNode* removed = path.back();
+    path.pop_back();
+    BinNode* child = removed->left != nullptr ? removed->left : removed->right;
+    // Splice the removed node out of its parent
+    if(path.empty()) {
+        this->root = child;
+    }
+    else if(path.back()->left == removed) {
+        path.back()->left = child;
+    }
+    else {
+        path.back()->right = child;
+    }
+    this->pool->recycle(removed);
+    --this->nodeCount;
+    // Heights, sizes and hashes along the path have changed
+    bool rebalance = this->balance == Balance::AVL;
+    while(!path.empty()) {
+        BinNode* cur = path.back();
+        path.pop_back();
+        // Rotations replace the subtree root, so the parent's link must be rewritten
+        BinNode*& link = path.empty() ? this->root : (path.back()->left == cur ? path.back()->left : path.back()->right);
+        rebalance ? BinTree::rebalance(link) : BinTree::updateNode(link);
+    }
+}
+
+/* AVL Helpers */
+
+int BinTree::height(const BinNode* cur) {
+    return cur == nullptr ? 0 : cur->height;
+}
+
+size_t BinTree::hash(const BinNode* cur) {
+    return cur == nullptr ? 0 : cur->hash;
+}
+
+size_t BinTree::subtreeSize(const BinNode* cur) {
+    return cur == nullptr ? 0 : cur->size;
+}
+
+void BinTree::updateNode(BinNode* cur) {
+    int left = height(cur->left);
+    int right = height(cur->right);
+    cur->height = 1 + (left > right ? left : right);
+    cur->size = 1 + subtreeSize(cur->left) + subtreeSize(cur->right);
+    // boost::hash_combine style mixing, the right hash is scrambled so mirrored shapes differ
+    size_t h = cur->data->hash();
+    h ^= hash(cur->left) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    h ^= hash(cur->right) * 0xff51afd7ed558ccdULL + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    cur->hash = h;
+}
+
+struct BinTree::Links {
+    BinNode*& left(BinNode* cur) const { return cur->left; }
+    BinNode*& right(BinNode* cur) const { return cur->right; }
+    int height(const BinNode* cur) const { return BinTree::height(cur); }
+    void update(BinNode* cur) const { BinTree::updateNode(cur); }
+};
+
+void BinTree::rebalance(BinNode*& cur) {
+    avl::rebalance(Links(), cur);
 }
 
 /* Auxilary Functions */
 
 std::ostream& operator<<(ostream& os, const BinTree& bst) {
+    // Values are rendered into a buffer that is written out in large chunks
+    std::string buffer;
+    buffer.reserve(std::min(RENDER_CHUNK, bst.nodeCount * 8) + 1);
     bool first = true;
-    auto h_operatoros = [&](BinTree::BinNode* cur, auto&& h_operatoros) {
-        if(cur == nullptr) return;
-        h_operatoros(cur->left, h_operatoros);
+    for(const NodeData& nd : bst) {
         if(!first) {
-            os << " ";
+            buffer += ' ';
         }
         else {
             first = false;
         }
-        os << *cur->data; 
-        h_operatoros(cur->right, h_operatoros);
-    };
-    h_operatoros(bst.root, h_operatoros);
-    os << std::endl;
+        buffer += nd.view();
+        flushBuffer(os, buffer, RENDER_CHUNK);
+    }
+    buffer += '\n';
+    flushBuffer(os, buffer, 0);
+    os.flush();
     return os;
 }
 
 BinTree::BinNode* BinTree::findNode(const NodeData& nd) const {
-    BinNode* result = nullptr;
-    auto h_findNode = [&](BinNode* cur, auto&& h_findNode) {
-        if(cur == nullptr) return; // Base Case
-        if(*(cur->data) == nd) { // Node matches NodeData, end recursion
-            result = cur;
-            return;
+    BINTREE_STAT(++this->counters.lookups);
+    if(this->ordered) {
+        // BST ordering allows a single comparison-guided descent
+        BinNode* cur = this->root;
+        while(cur != nullptr) {
+            BINTREE_STAT(++this->counters.lookupComparisons);
+            if(nd < *(cur->data)) {
+                cur = cur->left;
+            }
+            else if(nd > *(cur->data)) {
+                cur = cur->right;
+            }
+            else {
+                return cur;
+            }
         }
-        // Otherwise, continue recursion.
-        h_findNode(cur->left, h_findNode);
-        h_findNode(cur->right, h_findNode);
-    };
-    h_findNode(this->root, h_findNode);
-    return result;
+        return nullptr;
+    }
+    // Tree is not a BST, every node must be checked in pre-order
+    std::vector<BinNode*> stack;
+    if(this->root != nullptr) stack.push_back(this->root);
+    while(!stack.empty()) {
+        BinNode* cur = stack.back();
+        stack.pop_back();
+        BINTREE_STAT(++this->counters.lookupComparisons);
+        if(*(cur->data) == nd) return cur; // Node matches NodeData
+        if(cur->right != nullptr) stack.push_back(cur->right);
+        if(cur->left != nullptr) stack.push_back(cur->left);
+    }
+    return nullptr;
+}
+
+BinTree::BinNode* BinTree::findNode(std::string_view key) const {
+    BINTREE_STAT(++this->counters.lookups);
+    uint64_t prefix = NodeData::prefixOf(key);
+    if(this->ordered) {
+        BinNode* cur = this->root;
+        while(cur != nullptr) {
+            BINTREE_STAT(++this->counters.lookupComparisons);
+            int cmp = cur->data->compare(key, prefix);
+            if(cmp > 0) {
+                cur = cur->left;
+            }
+            else if(cmp < 0) {
+                cur = cur->right;
+            }
+            else {
+                return cur;
+            }
+        }
+        return nullptr;
+    }
+    std::vector<BinNode*> stack;
+    if(this->root != nullptr) stack.push_back(this->root);
+    while(!stack.empty()) {
+        BinNode* cur = stack.back();
+        stack.pop_back();
+        BINTREE_STAT(++this->counters.lookupComparisons);
+        if(cur->data->compare(key, prefix) == 0) return cur;
+        if(cur->right != nullptr) stack.push_back(cur->right);
+        if(cur->left != nullptr) stack.push_back(cur->left);
+    }
+    return nullptr;
 }
 
 int BinTree::getHeight(const NodeData& nd) const {
-    // Tree is not assumed to be a BST
-    // BinNode* node = findNode(nd); // Finds the node with 'nd'
-    // Therefore this function above is not used
-    auto h_findNode = [&](BinNode* cur, auto&& h_findNode) -> BinNode* {
-        if(cur == nullptr) return cur; // Base Case
-        if(nd == *(cur->data)) return cur;  // Node matches NodeData, end recursion
-        BinNode* left = h_findNode(cur->left, h_findNode);
-        BinNode* right = h_findNode(cur->right, h_findNode);
-        // Return the pointer that is not nullptr
-        // If both are nullptr, nullptr gets returned
-        return left == nullptr ? right : left;
-    };
-    BinNode* node = h_findNode(this->root, h_findNode);
+    BinNode* node = findNode(nd); // Finds the node with 'nd'
     if(node == nullptr) return 0;       
-    int height = 1;
-    int depth = 1;
-    auto h_getHeight = [&](BinNode* cur, int depth, auto&& h_getHeight) mutable {
-        if(cur == nullptr) return;
-        if(depth > height) {
-            height = depth;
-        }
-        h_getHeight(cur->left, depth+1, h_getHeight);
-        h_getHeight(cur->right, depth+1, h_getHeight);
-    };
-    h_getHeight(node, depth, h_getHeight);
-    return height;
+    return node->height;
+}
+
+void BinTree::getHeights(std::vector<std::pair<const NodeData*, int>>& heights) const {
+    heights.clear();
+    heights.reserve(this->nodeCount);
+    // In-order walk over the iterator's path, reading each node's cached height
+    for(Iterator it = this->begin(); it != this->end(); ++it) {
+        heights.emplace_back(it.path.back()->data, it.path.back()->height);
+    }
 }
 
 void BinTree::bstreeToArray(NodeData* nd[]) {
-    if(this->isEmpty()) return;
-    int index = 0;
-    auto h_bstreeToArray = [&](BinNode* cur, auto&& h_bstreeToArray) mutable {
-        if(cur == nullptr) return;
-        h_bstreeToArray(cur->left, h_bstreeToArray);
-        // Array is assumed to handle ownership of values
-        NodeData* newData = new NodeData(*(cur->data));
-        nd[index++] = newData;
-        h_bstreeToArray(cur->right, h_bstreeToArray);
-    };
-    h_bstreeToArray(this->root, h_bstreeToArray);
-    this->makeEmpty(); // Tree should be empty; deallocates memory for tree
+    std::vector<NodeData*> data;
+    this->bstreeToArray(data);
+    // Array is assumed to handle ownership of values
+    for(size_t i = 0; i < data.size(); i++) {
+        nd[i] = data[i];
+    }
 }
 
-void BinTree::arrayToBSTree(NodeData* nd[]) {
-    if(nd[0] == nullptr) return;
-    if(this->root == nullptr) {
-        this->root = new BinNode();
+void BinTree::bstreeToArray(std::vector<NodeData*>& nd) {
+    nd.clear();
+    if(this->isShared()) {
+        // Copy-on-write copies keep the shared values, this tree only drops its reference
+        for(const NodeData& data : *this) {
+            nd.push_back(new NodeData(data));
+        }
+        this->makeEmpty();
+        return;
     }
-    int numElements = 0;
+    this->release(nd); // Tree should be empty; deallocates memory for tree
+}
+
+void BinTree::arrayToBSTree(NodeData* nd[]) {
+    std::vector<NodeData*> data;
     for(int i = 0; i < 100; i++) { //Array is fixed to 100 elements
         if(nd[i] == nullptr) break; // Rest of Array is nullptr 
-        ++numElements;
-    }
-    auto h_arrayToBSTree = [](BinNode* cur, NodeData* subArray[], int size, auto&& h_arrayToBSTree) mutable -> void {
-        /* 
-         * [(1)]   -> base case -> set value and return
-         * [1, (2)]          --> [1], [2], [nullptr] // [size/2](1)
-         * [1, 2, (3), 4]    --> [1, 2], [3], [4] // [size/2](2), [1], [size - (size/2) - 1](1)
-         * [1, 2, (3), 4, 5] --> [1, 2], [3], [4, 5] // [size/2](2), [1], [size - (size/2) - 1](2)
-         */
-        if(size > 1) {
-            // Left Branch
-            int leftSize = size/2;
-            NodeData* leftArray[leftSize];
-            for(int i = 0; i < leftSize; i++) {
-                leftArray[i] = subArray[i];
-            }
-            cur->left = new BinNode();
-            h_arrayToBSTree(cur->left, leftArray, leftSize, h_arrayToBSTree);
-            // Root
-            // BST is assumed to handle ownership of values
-            // Root value will be midpoint
-            NodeData* newData = new NodeData(*(subArray[size/2]));
-            cur->data = newData; 
-            // Right Branch
-            if(size > 2) { 
-                int rightSize = size - (size/2) - 1;
-                NodeData* rightArray[rightSize];
-                for(int i = 0; i < size-(rightSize); i++) {
-                    rightArray[i] = subArray[(size/2)+1+i];
-                }
-                cur->right = new BinNode();
-                h_arrayToBSTree(cur->right, rightArray, rightSize, h_arrayToBSTree);
-            }
-        }
-        else if(size == 1) {
-            NodeData* newData = new NodeData(*(subArray[0]));
-            cur->data = newData; // Root value will be midpoint
+        data.push_back(nd[i]);
+        // BST handles ownership of values
+        nd[i] = nullptr;
+    }
+    this->arrayToBSTree(data);
+}
+
+void BinTree::arrayToBSTree(std::vector<NodeData*>& nd) {
+    this->makeEmpty();
+    // Counted repeats become one node, other repeats stay separate nodes and leave the tree unordered
+    std::vector<size_t> extra;
+    if(this->counting) foldRepeats(nd, &extra);
+    // Lookups may only use BST ordering if the array was strictly sorted, repeats would sit on both sides
+    for(size_t i = 1; i < nd.size() && this->ordered; i++) {
+        if(*nd[i-1] >= *nd[i]) this->ordered = false;
+    }
+    if(nd.empty()) return;
+    this->pool = std::make_shared<NodePool>();
+    // Every node comes from one block, element i is stored in block[i]
+    BinNode* block = this->pool->allocateBlock(nd.size());
+    this->root = buildBalanced(block, nd.data(), 0, nd.size(), 1);
+    for(size_t i = 0; i < extra.size(); i++) {
+        block[i].extra = extra[i];
+    }
+    this->nodeCount = nd.size();
+    nd.clear();
+}
+
+void BinTree::bulkLoad(std::vector<NodeData*>& nd) {
+    this->makeEmpty();
+    unsigned threads = nd.size() < PARALLEL_CUTOFF ? 1 : this->threads;
+    parallelSort(nd, threads);
+    // Duplicates are adjacent once sorted, only the first copy is kept and the rest are counted if counting
+    std::vector<size_t> extra;
+    foldRepeats(nd, this->counting ? &extra : nullptr);
+    if(nd.empty()) return;
+    this->pool = std::make_shared<NodePool>();
+    BinNode* block = this->pool->allocateBlock(nd.size());
+    this->root = buildBalanced(block, nd.data(), 0, nd.size(), threads);
+    for(size_t i = 0; i < extra.size(); i++) {
+        block[i].extra = extra[i];
+    }
+    this->nodeCount = nd.size();
+    nd.clear();
+}
+
+void BinTree::foldRepeats(std::vector<NodeData*>& nd, std::vector<size_t>* extra) {
+    size_t unique = 0;
+    for(size_t i = 0; i < nd.size(); i++) {
+        if(unique > 0 && *nd[unique-1] == *nd[i]) {
+            delete nd[i];
+            if(extra != nullptr) ++extra->back();
         }
         else {
-            throw new std::logic_error("Recursion Out of Bounds");
+            nd[unique++] = nd[i];
+            if(extra != nullptr) extra->push_back(0);
         }
-    };
-    h_arrayToBSTree(this->root, nd, numElements, h_arrayToBSTree);
-    // Delete values in array.
-    for(int i = 0; i < 100; i++) { 
-        if(nd[i] == nullptr) break; // Rest of array is nullptr
-        delete nd[i];   
-        nd[i] = nullptr;
     }
+    nd.resize(unique);
+}
+
+BinTree::BinNode* BinTree::buildBalanced(BinNode* block, NodeData* const* nd, size_t begin, size_t end, unsigned threads) {
+    /* 
+     * [(1)]   -> base case -> set value and return
+     * [1, (2)]          --> [1], [2], [nullptr] // [size/2](1)
+     * [1, 2, (3), 4]    --> [1, 2], [3], [4] // [size/2](2), [1], [size - (size/2) - 1](1)
+     * [1, 2, (3), 4, 5] --> [1, 2], [3], [4, 5] // [size/2](2), [1], [size - (size/2) - 1](2)
+     * Recursion depth is bounded by log2(size)
+     */
+    if(begin == end) return nullptr; // Base Case
+    size_t mid = begin + (end - begin) / 2;
+    BinNode* cur = &block[mid];
+    cur->data = nd[mid];
+    if(threads > 1 && end - begin >= PARALLEL_CUTOFF) {
+        // Halves write disjoint parts of the block, the left half gets its own thread
+        std::thread left([&] { cur->left = buildBalanced(block, nd, begin, mid, threads / 2); });
+        cur->right = buildBalanced(block, nd, mid + 1, end, threads - threads / 2);
+        left.join();
+    }
+    else {
+        cur->left = buildBalanced(block, nd, begin, mid, 1);
+        cur->right = buildBalanced(block, nd, mid + 1, end, 1);
+    }
+    updateNode(cur);
+    return cur;
+}
+
+bool BinTree::isOrdered() const {
+    return this->ordered;
+}
+
+BinTree BinTree::share() const {
+    BinTree copy(this->balance);
+    copy.root = this->root;
+    copy.nodeCount = this->nodeCount;
+    copy.pool = this->pool;
+    copy.ordered = this->ordered;
+    copy.counting = this->counting;
+    copy.threads = this->threads;
+    return copy;
+}
+
+void BinTree::setParallelism(unsigned threads) {
+    if(threads == 0) threads = std::thread::hardware_concurrency();
+    this->threads = threads == 0 ? 1 : threads;
+}
+
+unsigned BinTree::getParallelism() const {
+    return this->threads;
+}
+
+bool BinTree::isShared() const {
+    return this->pool != nullptr && this->pool.use_count() > 1;
+}
+
+size_t BinTree::size() const {
+    return this->nodeCount;
 }
 
 bool BinTree::isEmpty() const {
@@ -244,32 +674,827 @@ bool BinTree::isEmpty() const {
 }
 
 void BinTree::makeEmpty() {
-    if(this->root == nullptr) return;
-    auto h_makeEmpty = [](BinNode*& cur, auto&& h_makeEmpty) mutable {
-        if(cur == nullptr) return;
-        h_makeEmpty(cur->left, h_makeEmpty);
-        h_makeEmpty(cur->right, h_makeEmpty);
-        delete cur->data;
-        cur->data = nullptr;
-        delete cur;
-        cur = nullptr;
-    };
-    h_makeEmpty(this->root, h_makeEmpty);
+    if(this->threads > 1 && this->nodeCount >= PARALLEL_CUTOFF && !this->isShared()) {
+        this->pool->deleteData(this->threads);
+    }
+    // The pool deletes the nodes and data, unless a copy-on-write copy still uses them
+    this->root = nullptr;
+    this->nodeCount = 0;
+    this->pool.reset();
+    this->ordered = true; // An empty tree is trivially a BST
+}
+
+void BinTree::release(std::vector<NodeData*>& out) {
+    // Left children are rotated up until the current node has no left subtree,
+    // it is then the smallest remaining value and can be released before its right subtree.
+    // No stack is needed, and values are released in sorted order.
+    BinNode* cur = this->root;
+    while(cur != nullptr) {
+        if(cur->left != nullptr) {
+            BinNode* left = cur->left;
+            cur->left = left->right;
+            left->right = cur;
+            cur = left;
+        }
+        else {
+            out.push_back(cur->data);
+            // The pool no longer owns the value
+            cur->data = nullptr;
+            cur = cur->right;
+        }
+    }
+    this->root = nullptr;
+    this->nodeCount = 0;
+    this->pool.reset();
+    this->ordered = true;
+}
+
+void BinTree::detach() {
+    if(this->pool == nullptr) {
+        this->pool = std::make_shared<NodePool>();
+    }
+    else if(this->pool.use_count() > 1) {
+        std::shared_ptr<NodePool> unique = std::make_shared<NodePool>();
+        this->root = clone(this->root, this->nodeCount, *unique, this->threads);
+        this->pool = std::move(unique);
+    }
+}
+
+BinTree::BinNode* BinTree::clone(const BinNode* src, size_t count, NodePool& pool, unsigned threads) {
+    if(src == nullptr) return nullptr;
+    BinNode* block = pool.allocateBlock(count);
+    if(threads <= 1 || count < PARALLEL_CUTOFF) return cloneInto(src, block);
+    // Split the tree level by level until there is a frontier subtree per thread
+    std::vector<const BinNode*> top, frontier{src};
+    while(!frontier.empty() && frontier.size() < threads) {
+        std::vector<const BinNode*> next;
+        for(const BinNode* cur : frontier) {
+            top.push_back(cur);
+            if(cur->left != nullptr) next.push_back(cur->left);
+            if(cur->right != nullptr) next.push_back(cur->right);
+        }
+        frontier = std::move(next);
+    }
+    // Each frontier subtree is cloned into its own contiguous range of the block
+    std::vector<size_t> offsets(frontier.size() + 1, 0);
+    for(size_t i = 0; i < frontier.size(); i++) {
+        offsets[i+1] = offsets[i] + subtreeSize(frontier[i]);
+    }
+    std::vector<BinNode*> copies(frontier.size());
+    parallelFor(frontier.size(), threads, [&](size_t begin, size_t end) {
+        for(size_t i = begin; i < end; i++) copies[i] = cloneInto(frontier[i], block + offsets[i]);
+    });
+    std::unordered_map<const BinNode*, BinNode*> copyOf;
+    for(size_t i = 0; i < frontier.size(); i++) copyOf[frontier[i]] = copies[i];
+    // Top nodes fill the rest of the block, children are copied before their parents
+    size_t next = offsets.back();
+    for(auto it = top.rbegin(); it != top.rend(); ++it) {
+        const BinNode* cur = *it;
+        BinNode* copy = &block[next++];
+        copy->data = new NodeData(*(cur->data));
+        copy->height = cur->height;
+        copy->hash = cur->hash;
+        copy->size = cur->size;
+        copy->extra = cur->extra;
+        copy->left = cur->left == nullptr ? nullptr : copyOf[cur->left];
+        copy->right = cur->right == nullptr ? nullptr : copyOf[cur->right];
+        copyOf[cur] = copy;
+    }
+    return copyOf[src];
+}
+
+BinTree::BinNode* BinTree::cloneInto(const BinNode* src, BinNode* block) {
+    // Pre-order copy, each source node is paired with the link its copy is stored in
+    BinNode* copyRoot = nullptr;
+    size_t next = 0;
+    std::vector<std::pair<const BinNode*, BinNode**>> links{{src, &copyRoot}};
+    while(!links.empty()) {
+        auto [cur, link] = links.back();
+        links.pop_back();
+        BinNode* copy = &block[next++];
+        copy->data = new NodeData(*(cur->data));
+        copy->height = cur->height;
+        copy->hash = cur->hash;
+        copy->size = cur->size;
+        copy->extra = cur->extra;
+        *link = copy;
+        if(cur->right != nullptr) links.emplace_back(cur->right, &copy->right);
+        if(cur->left != nullptr) links.emplace_back(cur->left, &copy->left);
+    }
+    return copyRoot;
 }
 
 void BinTree::displaySideways() const { 
-    if(this->root == nullptr) return;
-    auto h_sideways = [](BinNode* cur, int level, auto&& h_sideways) -> void {
-        if (cur != nullptr) {
+    this->displaySideways(cout);
+}
+
+void BinTree::displaySideways(std::ostream& os, int maxDepth) const {
+    std::string buffer;
+    // Reverse in-order traversal (right, node, left) with each node's level
+    std::vector<std::pair<const BinNode*, int>> stack;
+    const BinNode* cur = this->root;
+    int level = 0;
+    auto indent = [&buffer](int level) {
+        // indent for readability, 4 spaces per depth level 
+        buffer.append(4 * static_cast<size_t>(level + 1), ' ');
+    };
+    while(cur != nullptr || !stack.empty()) {
+        while(cur != nullptr) {
             level++;
-            h_sideways(cur->right, level, h_sideways);
-            // indent for readability, 4 spaces per depth level 
-            for (int i = level; i >= 0; i--) {
-                cout << "    ";
+            if(maxDepth > 0 && level > maxDepth) {
+                // Subtree below the limit is summarized by its cached size
+                indent(level);
+                buffer += "... (" + std::to_string(cur->size) + ")\n";
+                cur = nullptr;
+                break;
             }
-            cout << *cur->data << endl;        // display information of object
-            h_sideways(cur->left, level, h_sideways);
-	    }
+            stack.emplace_back(cur, level);
+            cur = cur->right;
+        }
+        if(stack.empty()) break;
+        auto [node, nodeLevel] = stack.back();
+        stack.pop_back();
+        indent(nodeLevel);
+        buffer += node->data->view();            // display information of object
+        buffer += '\n';
+        flushBuffer(os, buffer, RENDER_CHUNK);
+        cur = node->left;
+        level = nodeLevel;
+    }
+    flushBuffer(os, buffer, 0);
+}
+
+BinTree::Stats BinTree::getStats() const {
+    Stats stats = Stats();
+#ifdef BINTREE_STATS
+    stats.counted = true;
+    stats.inserts = this->counters.inserts;
+    stats.insertComparisons = this->counters.insertComparisons;
+    stats.lookups = this->counters.lookups;
+    stats.lookupComparisons = this->counters.lookupComparisons;
+#endif
+    stats.size = this->nodeCount;
+    stats.height = height(this->root);
+    while((size_t(1) << stats.optimalHeight) - 1 < this->nodeCount) ++stats.optimalHeight;
+    stats.imbalance = stats.optimalHeight == 0 ? 1.0 : double(stats.height) / stats.optimalHeight;
+    // Pre-order walk with each node's depth
+    std::vector<std::pair<const BinNode*, size_t>> stack;
+    if(this->root != nullptr) stack.emplace_back(this->root, 0);
+    while(!stack.empty()) {
+        auto [cur, depth] = stack.back();
+        stack.pop_back();
+        if(stats.depths.size() <= depth) stats.depths.resize(depth + 1);
+        ++stats.depths[depth];
+        stats.payloadBytes += sizeof(NodeData) + cur->data->view().size();
+        if(cur->right != nullptr) stack.emplace_back(cur->right, depth + 1);
+        if(cur->left != nullptr) stack.emplace_back(cur->left, depth + 1);
+    }
+    stats.payloads = this->nodeCount;
+    if(this->pool != nullptr) {
+        stats.nodeBlocks = this->pool->blockCount();
+        stats.nodeBytes = this->pool->capacity() * sizeof(BinNode);
+    }
+    return stats;
+}
+
+void BinTree::Stats::writeJson(std::ostream& os) const {
+    os << "{\"counted\":" << (this->counted ? "true" : "false")
+       << ",\"inserts\":" << this->inserts << ",\"insertComparisons\":" << this->insertComparisons
+       << ",\"lookups\":" << this->lookups << ",\"lookupComparisons\":" << this->lookupComparisons
+       << ",\"size\":" << this->size << ",\"height\":" << this->height
+       << ",\"optimalHeight\":" << this->optimalHeight << ",\"imbalance\":" << this->imbalance
+       << ",\"nodeBlocks\":" << this->nodeBlocks << ",\"nodeBytes\":" << this->nodeBytes
+       << ",\"payloads\":" << this->payloads << ",\"payloadBytes\":" << this->payloadBytes
+       << ",\"depths\":[";
+    for(size_t i = 0; i < this->depths.size(); i++) {
+        os << (i > 0 ? "," : "") << this->depths[i];
+    }
+    os << "]}";
+}
+
+/* Node Pool */
+
+BinTree::NodePool::~NodePool() {
+    for(Block& block : this->blocks) {
+        for(size_t i = 0; i < block.used; i++) {
+            delete block.nodes[i].data;
+        }
+        delete[] block.nodes;
+    }
+}
+
+BinTree::BinNode* BinTree::NodePool::allocate() {
+    if(this->freeList != nullptr) {
+        BinNode* node = this->freeList;
+        this->freeList = node->left;
+        *node = BinNode();
+        return node;
+    }
+    if(this->blocks.empty() || this->blocks.back().used == this->blocks.back().size) {
+        // Blocks double in size, capped so a mostly empty block wastes little memory
+        const size_t MINBLOCK = 16, MAXBLOCK = 4096;
+        size_t size = this->blocks.empty() ? MINBLOCK : this->blocks.back().size * 2;
+        if(size > MAXBLOCK) size = MAXBLOCK;
+        this->blocks.push_back({new BinNode[size](), 0, size});
+    }
+    Block& block = this->blocks.back();
+    return &block.nodes[block.used++];
+}
+
+void BinTree::NodePool::recycle(BinNode* node) {
+    node->data = nullptr;
+    node->right = nullptr;
+    node->left = this->freeList;
+    this->freeList = node;
+}
+
+void BinTree::NodePool::deleteData(unsigned threads) {
+    // starts[b] is the index of block b's first node when the used nodes of all blocks are numbered in order
+    std::vector<size_t> starts;
+    size_t total = 0;
+    for(const Block& block : this->blocks) {
+        starts.push_back(total);
+        total += block.used;
+    }
+    if(total < PARALLEL_CUTOFF) threads = 1;
+    // One range per thread, so threads are started once however many blocks the pool has
+    parallelFor(total, threads, [this, &starts](size_t begin, size_t end) {
+        size_t b = std::upper_bound(starts.begin(), starts.end(), begin) - starts.begin() - 1;
+        for(size_t i = begin; i < end; b++) {
+            Block& block = this->blocks[b];
+            size_t last = std::min(end - starts[b], block.used);
+            for(size_t j = i - starts[b]; j < last; j++) {
+                delete block.nodes[j].data;
+                block.nodes[j].data = nullptr;
+            }
+            i = starts[b] + last;
+        }
+    });
+}
+
+size_t BinTree::NodePool::blockCount() const {
+    return this->blocks.size();
+}
+
+size_t BinTree::NodePool::capacity() const {
+    size_t nodes = 0;
+    for(const Block& block : this->blocks) {
+        nodes += block.size;
+    }
+    return nodes;
+}
+
+BinTree::BinNode* BinTree::NodePool::allocateBlock(size_t count) {
+    BinNode* nodes = new BinNode[count]();
+    // Inserted before the last block so allocate() keeps filling a partial block
+    Block block{nodes, count, count};
+    this->blocks.insert(this->blocks.empty() ? this->blocks.end() : this->blocks.end() - 1, block);
+    return nodes;
+}
+
+/* Iterator */
+
+BinTree::Iterator::Iterator() {
+    this->tree = nullptr;
+}
+
+BinTree::Iterator::Iterator(const BinTree* tree) {
+    this->tree = tree;
+}
+
+void BinTree::Iterator::pushLeftmost(const BinNode* cur) {
+    for(; cur != nullptr; cur = cur->left) {
+        this->path.push_back(cur);
+    }
+}
+
+void BinTree::Iterator::pushRightmost(const BinNode* cur) {
+    for(; cur != nullptr; cur = cur->right) {
+        this->path.push_back(cur);
+    }
+}
+
+BinTree::Iterator::reference BinTree::Iterator::operator*() const {
+    return *(this->path.back()->data);
+}
+
+BinTree::Iterator::pointer BinTree::Iterator::operator->() const {
+    return this->path.back()->data;
+}
+
+BinTree::Iterator& BinTree::Iterator::operator++() {
+    const BinNode* cur = this->path.back();
+    if(cur->right != nullptr) {
+        // Successor is the leftmost node of the right subtree
+        this->pushLeftmost(cur->right);
+        return *this;
+    }
+    // Otherwise climb until we leave a left subtree, an empty path is end()
+    this->path.pop_back();
+    while(!this->path.empty() && this->path.back()->right == cur) {
+        cur = this->path.back();
+        this->path.pop_back();
+    }
+    return *this;
+}
+
+BinTree::Iterator BinTree::Iterator::operator++(int) {
+    Iterator old = *this;
+    ++(*this);
+    return old;
+}
+
+BinTree::Iterator& BinTree::Iterator::operator--() {
+    if(this->path.empty()) {
+        // Predecessor of end() is the largest value
+        this->pushRightmost(this->tree->root);
+        return *this;
+    }
+    const BinNode* cur = this->path.back();
+    if(cur->left != nullptr) {
+        // Predecessor is the rightmost node of the left subtree
+        this->pushRightmost(cur->left);
+        return *this;
+    }
+    // Otherwise climb until we leave a right subtree
+    this->path.pop_back();
+    while(!this->path.empty() && this->path.back()->left == cur) {
+        cur = this->path.back();
+        this->path.pop_back();
+    }
+    return *this;
+}
+
+BinTree::Iterator BinTree::Iterator::operator--(int) {
+    Iterator old = *this;
+    --(*this);
+    return old;
+}
+
+bool BinTree::Iterator::operator==(const Iterator& rhs) const {
+    if(this->path.empty() || rhs.path.empty()) {
+        return this->path.empty() && rhs.path.empty();
+    }
+    return this->path.back() == rhs.path.back();
+}
+
+bool BinTree::Iterator::operator!=(const Iterator& rhs) const {
+    return !(this->operator==(rhs));
+}
+
+BinTree::Iterator BinTree::begin() const {
+    Iterator it(this);
+    if(!this->isEmpty()) it.pushLeftmost(this->root);
+    return it;
+}
+
+BinTree::Iterator BinTree::end() const {
+    return Iterator(this);
+}
+
+/* Order Statistics */
+
+size_t BinTree::rank(const NodeData& nd) const {
+    return this->countBelow(nd, false);
+}
+
+const NodeData* BinTree::select(size_t k) const {
+    const BinNode* cur = this->root;
+    while(cur != nullptr) {
+        size_t left = subtreeSize(cur->left);
+        if(k < left) {
+            cur = cur->left;
+        }
+        else if(k == left) {
+            return cur->data;
+        }
+        else {
+            // Skip the left subtree and this node
+            k -= left + 1;
+            cur = cur->right;
+        }
+    }
+    return nullptr;
+}
+
+size_t BinTree::countRange(const NodeData& lo, const NodeData& hi) const {
+    if(hi < lo) return 0;
+    return this->countBelow(hi, true) - this->countBelow(lo, false);
+}
+
+BinTree::Iterator BinTree::lowerBound(const NodeData& nd) const {
+    return this->bound(nd, false);
+}
+
+BinTree::Iterator BinTree::upperBound(const NodeData& nd) const {
+    return this->bound(nd, true);
+}
+
+BinTree::Range BinTree::range(const NodeData& lo, const NodeData& hi) const {
+    if(hi < lo) return Range{this->end(), this->end()};
+    return Range{this->lowerBound(lo), this->upperBound(hi)};
+}
+
+size_t BinTree::countBelow(const NodeData& nd, bool inclusive) const {
+    size_t below = 0;
+    const BinNode* cur = this->root;
+    while(cur != nullptr) {
+        bool goRight = inclusive ? *(cur->data) <= nd : *(cur->data) < nd;
+        if(goRight) {
+            // This node and its left subtree are all below 'nd'
+            below += subtreeSize(cur->left) + 1;
+            cur = cur->right;
+        }
+        else {
+            cur = cur->left;
+        }
+    }
+    return below;
+}
+
+BinTree::Iterator BinTree::bound(const NodeData& nd, bool strict) const {
+    Iterator it(this);
+    // The result is the last node where the descent turned left
+    size_t found = 0;
+    const BinNode* cur = this->root;
+    while(cur != nullptr) {
+        it.path.push_back(cur);
+        bool goLeft = strict ? nd < *(cur->data) : nd <= *(cur->data);
+        if(goLeft) {
+            found = it.path.size();
+            cur = cur->left;
+        }
+        else {
+            cur = cur->right;
+        }
+    }
+    // Ancestors of the result remain as the iterator's path, an empty path is end()
+    it.path.resize(found);
+    return it;
+}
+
+/* Counting */
+
+void BinTree::setCounting(bool counting) {
+    this->counting = counting;
+}
+
+bool BinTree::isCounting() const {
+    return this->counting;
+}
+
+size_t BinTree::count(const NodeData& nd) const {
+    const BinNode* node = this->findNode(nd);
+    return node == nullptr ? 0 : 1 + node->extra;
+}
+
+void BinTree::topK(size_t k, std::vector<std::pair<const NodeData*, size_t>>& top) const {
+    top.clear();
+    if(k == 0) return;
+    // Min-heap of the k most frequent values seen so far, the least frequent is on top
+    // Among equal counts the smaller value ranks higher, so it is kept
+    auto ranksHigher = [](const std::pair<const NodeData*, size_t>& lhs, const std::pair<const NodeData*, size_t>& rhs) {
+        return lhs.second > rhs.second || (lhs.second == rhs.second && *lhs.first < *rhs.first);
     };
-	h_sideways(this->root, 0, h_sideways);
-}
\ No newline at end of file
+    for(Iterator it = this->begin(); it != this->end(); ++it) {
+        const BinNode* node = it.path.back();
+        std::pair<const NodeData*, size_t> entry(node->data, 1 + node->extra);
+        if(top.size() < k) {
+            top.push_back(entry);
+            std::push_heap(top.begin(), top.end(), ranksHigher);
+        }
+        else if(ranksHigher(entry, top.front())) {
+            std::pop_heap(top.begin(), top.end(), ranksHigher);
+            top.back() = entry;
+            std::push_heap(top.begin(), top.end(), ranksHigher);
+        }
+    }
+    std::sort_heap(top.begin(), top.end(), ranksHigher);
+}
+
+void BinTree::displayCounts(std::ostream& os) const {
+    std::string buffer;
+    bool first = true;
+    for(Iterator it = this->begin(); it != this->end(); ++it) {
+        const BinNode* node = it.path.back();
+        if(!first) {
+            buffer += ' ';
+        }
+        else {
+            first = false;
+        }
+        buffer += node->data->view();
+        buffer += ':';
+        buffer += std::to_string(1 + node->extra);
+        flushBuffer(os, buffer, RENDER_CHUNK);
+    }
+    buffer += '\n';
+    flushBuffer(os, buffer, 0);
+}
+
+/* Set Algebra */
+
+void BinTree::sortedValues(std::vector<const NodeData*>& values) const {
+    values.clear();
+    values.reserve(this->nodeCount);
+    for(Iterator it = this->begin(); it != this->end(); ++it) {
+        values.push_back(it.path.back()->data);
+    }
+    if(!this->ordered) {
+        std::sort(values.begin(), values.end(), [](const NodeData* lhs, const NodeData* rhs) { return *lhs < *rhs; });
+    }
+}
+
+BinTree BinTree::merge(const BinTree& bst, bool keepLeft, bool keepBoth, bool keepRight) const {
+    std::vector<const NodeData*> lhs, rhs;
+    this->sortedValues(lhs);
+    bst.sortedValues(rhs);
+    std::vector<NodeData*> merged;
+    size_t i = 0, j = 0;
+    while(i < lhs.size() || j < rhs.size()) {
+        // A side that has run out sorts after every remaining value of the other
+        if(j == rhs.size() || (i < lhs.size() && *lhs[i] < *rhs[j])) {
+            if(keepLeft) merged.push_back(new NodeData(*lhs[i]));
+            i++;
+        }
+        else if(i == lhs.size() || *rhs[j] < *lhs[i]) {
+            if(keepRight) merged.push_back(new NodeData(*rhs[j]));
+            j++;
+        }
+        else {
+            if(keepBoth) merged.push_back(new NodeData(*lhs[i]));
+            i++;
+            j++;
+        }
+    }
+    BinTree result(this->balance);
+    result.threads = this->threads;
+    result.arrayToBSTree(merged);
+    return result;
+}
+
+BinTree BinTree::setUnion(const BinTree& bst) const {
+    return this->merge(bst, true, true, true);
+}
+
+BinTree BinTree::intersection(const BinTree& bst) const {
+    return this->merge(bst, false, true, false);
+}
+
+BinTree BinTree::difference(const BinTree& bst) const {
+    return this->merge(bst, true, false, false);
+}
+
+bool BinTree::isSubset(const BinTree& bst) const {
+    if(this->nodeCount > bst.nodeCount) return false;
+    std::vector<const NodeData*> lhs, rhs;
+    this->sortedValues(lhs);
+    bst.sortedValues(rhs);
+    size_t j = 0;
+    for(const NodeData* nd : lhs) {
+        // Skip values of 'bst' that are smaller, the next one must be equal
+        while(j < rhs.size() && *rhs[j] < *nd) j++;
+        if(j == rhs.size() || *rhs[j] != *nd) return false;
+        j++;
+    }
+    return true;
+}
+
+/* Loading */
+
+BinTree::Loader::Loader(std::istream& in, size_t blockSize) : in(in), buffer(blockSize > 0 ? blockSize : 1) {
+    this->begin = 0;
+    this->end = 0;
+}
+
+bool BinTree::Loader::refill() {
+    if(!this->in) return false;
+    // Unread bytes move to the front, a token split across blocks is kept whole
+    std::copy(this->buffer.begin() + this->begin, this->buffer.begin() + this->end, this->buffer.begin());
+    this->end -= this->begin;
+    this->begin = 0;
+    if(this->end == this->buffer.size()) this->buffer.resize(this->buffer.size() * 2);
+    this->in.read(this->buffer.data() + this->end, this->buffer.size() - this->end);
+    size_t read = static_cast<size_t>(this->in.gcount());
+    this->end += read;
+    return read > 0;
+}
+
+bool BinTree::Loader::next(BinTree& tree) {
+    auto isSpace = [](char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    };
+    bool found = false;
+    for(;;) {
+        // Skip whitespace before the next token
+        while(this->begin < this->end && isSpace(this->buffer[this->begin])) ++this->begin;
+        if(this->begin == this->end) {
+            if(!this->refill()) return found;
+            continue;
+        }
+        size_t stop = this->begin;
+        while(stop < this->end && !isSpace(this->buffer[stop])) ++stop;
+        if(stop == this->end && this->in) {
+            // Token may continue in the next block
+            this->refill();
+            continue;
+        }
+        std::string_view token(this->buffer.data() + this->begin, stop - this->begin);
+        this->begin = stop;
+        found = true;
+        if(token == "$$") return true;
+        tree.emplace(token);
+    }
+}
+
+size_t BinTree::loadAll(std::istream& in, std::vector<BinTree>& trees, Balance balance) {
+    Loader loader(in);
+    size_t loaded = 0;
+    for(;;) {
+        trees.emplace_back(balance);
+        if(!loader.next(trees.back())) break;
+        ++loaded;
+    }
+    // The last tree was created for a section that did not exist
+    trees.pop_back();
+    return loaded;
+}
+
+/* Snapshots */
+
+namespace {
+
+    const char SNAPSHOT_MAGIC[8] = {'B', 'I', 'N', 'T', 'R', 'E', 'E', '1'};
+
+    // Shape bits of a node, stored in pre-order
+    const unsigned HAS_LEFT = 1, HAS_RIGHT = 2;
+
+}
+
+BinTree::Snapshot::Snapshot(const std::string& path) {
+    this->map = nullptr;
+    this->length = 0;
+    this->header = nullptr;
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) return;
+    struct stat info;
+    if(fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(Header)) {
+        this->length = static_cast<size_t>(info.st_size);
+        void* mapped = mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mapped != MAP_FAILED) this->map = static_cast<const char*>(mapped);
+    }
+    close(fd); // The mapping stays valid after the descriptor is closed
+    if(this->map == nullptr) return;
+    const Header* header = reinterpret_cast<const Header*>(this->map);
+    // Sections follow the header: offsets, shape, keys
+    size_t offsetBytes = (header->count + 1) * sizeof(uint64_t);
+    size_t shapeBytes = (header->count * 2 + 7) / 8;
+    if(std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0
+        || header->count > this->length / sizeof(uint64_t) || header->blobBytes > this->length
+        || sizeof(Header) + offsetBytes + shapeBytes + header->blobBytes != this->length) {
+        return;
+    }
+    this->offsets = reinterpret_cast<const uint64_t*>(this->map + sizeof(Header));
+    this->shape = reinterpret_cast<const unsigned char*>(this->map + sizeof(Header) + offsetBytes);
+    this->blob = this->map + sizeof(Header) + offsetBytes + shapeBytes;
+    // A damaged file must not send lookups or load() outside the mapping
+    for(size_t i = 0; i < header->count; i++) {
+        if(this->offsets[i] > this->offsets[i+1]) return;
+    }
+    if(this->offsets[0] != 0 || this->offsets[header->count] != header->blobBytes) return;
+    size_t missing = header->count > 0 ? 1 : 0; // Children the shape has promised but not yet given
+    for(size_t i = 0; i < header->count; i++) {
+        if(missing == 0) return;
+        unsigned bits = this->shape[i / 4] >> (i % 4 * 2);
+        missing = missing - 1 + ((bits & HAS_LEFT) ? 1 : 0) + ((bits & HAS_RIGHT) ? 1 : 0);
+    }
+    if(missing != 0) return;
+    this->header = header;
+}
+
+BinTree::Snapshot::~Snapshot() {
+    if(this->map != nullptr) munmap(const_cast<char*>(this->map), this->length);
+}
+
+bool BinTree::Snapshot::isOpen() const {
+    return this->header != nullptr;
+}
+
+size_t BinTree::Snapshot::size() const {
+    return this->header == nullptr ? 0 : this->header->count;
+}
+
+std::string_view BinTree::Snapshot::operator[](size_t k) const {
+    return std::string_view(this->blob + this->offsets[k], this->offsets[k+1] - this->offsets[k]);
+}
+
+bool BinTree::Snapshot::contains(std::string_view key) const {
+    if(!this->isOpen()) return false;
+    if(!this->header->ordered) {
+        for(size_t i = 0; i < this->size(); i++) {
+            if((*this)[i] == key) return true;
+        }
+        return false;
+    }
+    // string_view compares chars as unsigned bytes, the same order as NodeData
+    size_t low = 0, high = this->size();
+    while(low < high) {
+        size_t mid = low + (high - low) / 2;
+        int cmp = (*this)[mid].compare(key);
+        if(cmp < 0) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return low < this->size() && (*this)[low] == key;
+}
+
+bool BinTree::save(const std::string& path) const {
+    Snapshot::Header header;
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.count = this->nodeCount;
+    header.ordered = this->ordered;
+    std::vector<uint64_t> offsets{0};
+    offsets.reserve(this->nodeCount + 1);
+    for(const NodeData& nd : *this) {
+        offsets.push_back(offsets.back() + nd.view().size());
+    }
+    header.blobBytes = offsets.back();
+    // Pre-order walk recording which children each node has
+    std::vector<unsigned char> shape((this->nodeCount * 2 + 7) / 8);
+    std::vector<const BinNode*> stack;
+    if(this->root != nullptr) stack.push_back(this->root);
+    for(size_t i = 0; !stack.empty(); i++) {
+        const BinNode* cur = stack.back();
+        stack.pop_back();
+        unsigned bits = (cur->left != nullptr ? HAS_LEFT : 0) | (cur->right != nullptr ? HAS_RIGHT : 0);
+        shape[i / 4] |= bits << (i % 4 * 2);
+        if(cur->right != nullptr) stack.push_back(cur->right);
+        if(cur->left != nullptr) stack.push_back(cur->left);
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(shape.data()), shape.size());
+    for(const NodeData& nd : *this) {
+        out.write(nd.view().data(), nd.view().size());
+    }
+    return static_cast<bool>(out.flush());
+}
+
+bool BinTree::load(const std::string& path) {
+    Snapshot snapshot(path);
+    if(!snapshot.isOpen()) return false;
+    this->load(snapshot);
+    return true;
+}
+
+void BinTree::load(const Snapshot& snapshot) {
+    this->makeEmpty();
+    size_t count = snapshot.size();
+    this->ordered = snapshot.header->ordered;
+    if(count == 0) return;
+    this->pool = std::make_shared<NodePool>();
+    // Nodes are laid out in pre-order, node i is block[i]
+    BinNode* block = this->pool->allocateBlock(count);
+    // Nodes that are still waiting for a child
+    std::vector<BinNode*> pending;
+    for(size_t i = 0; i < count; i++) {
+        BinNode* cur = &block[i];
+        if(i > 0) {
+            // The next node in pre-order is the left child if that is still missing, otherwise the right child
+            BinNode* parent = pending.back();
+            unsigned parentBits = snapshot.shape[(parent - block) / 4] >> ((parent - block) % 4 * 2);
+            if((parentBits & HAS_LEFT) && parent->left == nullptr) {
+                parent->left = cur;
+                if(!(parentBits & HAS_RIGHT)) pending.pop_back();
+            }
+            else {
+                parent->right = cur;
+                pending.pop_back();
+            }
+        }
+        unsigned bits = snapshot.shape[i / 4] >> (i % 4 * 2) & 3;
+        if(bits != 0) pending.push_back(cur);
+    }
+    this->root = &block[0];
+    // In-order walk hands out the keys, which are stored in in-order
+    size_t k = 0;
+    for(BinNode* cur = this->root; cur != nullptr || !pending.empty(); ) {
+        while(cur != nullptr) {
+            pending.push_back(cur);
+            cur = cur->left;
+        }
+        cur = pending.back();
+        pending.pop_back();
+        cur->data = new NodeData(std::string(snapshot[k++]));
+        cur = cur->right;
+    }
+    // Children come after their parent in pre-order, so a reverse sweep updates them first
+    for(size_t i = count; i-- > 0; ) {
+        BinTree::updateNode(&block[i]);
+    }
+    this->nodeCount = count;
+}
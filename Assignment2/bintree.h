@@ -8,33 +8,275 @@
 
 #pragma once
 
+#include<cstddef>
+#include<cstdint>
 #include<iostream>
+#include<iterator>
+#include<memory>
+#include<string>
+#include<string_view>
+#include<type_traits>
+#include<utility>
+#include<vector>
 #include"nodedata.h"
 
+// Operation counters reported by BinTree::getStats(), off unless compiled with -DBINTREE_STATS
+#ifdef BINTREE_STATS
+#define BINTREE_STAT(statement) statement
+#else
+#define BINTREE_STAT(statement)
+#endif
+
 class BinTree {
 
     /**
      * @brief Prints the BST.
+     * @details Values are buffered and written in large chunks, the stream is flushed once.
      * @return ostream& 
      */
     friend std::ostream& operator<<(std::ostream&, const BinTree&);
 
+public:
+
+    /**
+     * @brief Balancing strategy applied by insert().
+     * @details
+     * None: plain BST insertion, the shape depends on insertion order.
+     * AVL: subtrees are rotated after each insert so the height stays O(log n).
+     */
+    enum class Balance { None, AVL };
+
+    class Iterator;
+
 private:
 
     struct BinNode {
         BinNode *left, *right;
         NodeData *data;
+        int height; // Levels in the subtree rooted here, a leaf is 1
+        size_t hash; // Hash of the subtree's shape and values, see updateNode()
+        size_t size; // Number of nodes in the subtree rooted here
+        size_t extra; // Occurrences beyond the first, only non-zero when counting duplicates
+    };
+
+    /**
+     * @brief Owns the BinNodes of a tree and the NodeData they point to.
+     * @details
+     * Nodes are carved out of contiguous blocks instead of being allocated one at a time.
+     * Copy-on-write copies share a pool, the NodeData is deleted with the last owner.
+     */
+    class NodePool {
+    public:
+        NodePool() = default;
+        NodePool(const NodePool&) = delete;
+        NodePool& operator=(const NodePool&) = delete;
+        /**
+         * @brief Frees every block and deletes the NodeData of every used node.
+         */
+        ~NodePool();
+        /**
+         * @brief Returns a zero-initialized node, reusing a recycled node if there is one.
+         */
+        BinNode* allocate();
+        /**
+         * @brief Puts a node on the free list for reuse by allocate().
+         * @pre The node's data has been deleted or handed off.
+         */
+        void recycle(BinNode*);
+        /**
+         * @brief Returns 'count' contiguous zero-initialized nodes.
+         */
+        BinNode* allocateBlock(size_t);
+        /**
+         * @brief Deletes the NodeData of every used node, splitting all blocks across threads at once.
+         * @details Pools below the parallel cutoff are cleared on the calling thread.
+         * @post Every node's data is nullptr.
+         */
+        void deleteData(unsigned);
+        /**
+         * @brief Returns the number of blocks allocated.
+         */
+        size_t blockCount() const;
+        /**
+         * @brief Returns the number of nodes in all blocks, used or not.
+         */
+        size_t capacity() const;
+    private:
+        struct Block {
+            BinNode* nodes;
+            size_t used, size;
+        };
+        std::vector<Block> blocks;
+        BinNode* freeList = nullptr; // Recycled nodes, linked through 'left'
     };
 
     BinNode* root;
+    size_t nodeCount; // Number of nodes in the tree
+    std::shared_ptr<NodePool> pool; // nullptr until the first node is allocated
+    Balance balance;
+    bool ordered; // false once arrayToBSTree() is given unsorted or repeated data
+    bool counting; // Duplicates are counted instead of rejected, see setCounting()
+    unsigned threads; // Threads used by bulk and whole-tree operations, see setParallelism()
+#ifdef BINTREE_STATS
+    struct Counters {
+        uint64_t inserts = 0, insertComparisons = 0;
+        uint64_t lookups = 0, lookupComparisons = 0;
+    };
+    mutable Counters counters; // Updated by const lookups, not synchronized
+#endif
 
     /**
      * @brief Gets the BinNode that contains a specific NodeData
+     * @details
+     * Ordered trees are searched iteratively along a single root-to-leaf path.
+     * Unordered trees fall back to a full traversal.
      * @param nd NodeData to search for.
      * @return nullptr if value not found
      * @return BinNode* Pointer to BinNode containing NodeData
      */
     BinNode* findNode(const NodeData&) const;
+    /**
+     * @brief Gets the BinNode whose NodeData equals a raw key, see findNode(const NodeData&).
+     */
+    BinNode* findNode(std::string_view) const;
+    /**
+     * @brief Follows BST ordering from the root towards a key without modifying the tree.
+     * @param key Key to search for.
+     * @param path Receives the links followed from the root.
+     * @return The link holding the key, or the empty link where it would be inserted.
+     */
+    BinNode** descend(std::string_view, std::vector<BinNode**>&);
+    /**
+     * @brief Finds the empty link where a key would be inserted.
+     * @details A shared tree is only cloned once the insert is certain to change it.
+     * @param key Key to search for.
+     * @param path Receives the links followed from the root.
+     * @return nullptr If the key is a duplicate, it is counted when counting duplicates.
+     * @post The tree's nodes are not shared, unless an uncounted duplicate was found.
+     */
+    BinNode** findLink(std::string_view, std::vector<BinNode**>&);
+    /**
+     * @brief Places a value at an empty link found by a descent and updates the path back to the root.
+     * @details Ancestors are rebalanced in Balance::AVL mode.
+     * @param link Empty link for the new node.
+     * @param path Links followed from the root to 'link'.
+     * @param nd NodeData to insert.
+     */
+    void linkNode(BinNode**, std::vector<BinNode**>&, NodeData*);
+    /**
+     * @brief Inserts a Node into the BST.
+     * @param nd NodeData to insert.
+     * @return true If node was successfully inserted into the Tree.
+     * @return false If the node was a duplicate value.
+     */
+    bool insertNode(NodeData*);
+    /**
+     * @brief Unlinks the last node of 'path' and deletes its data.
+     * @details 
+     * A node with two children takes its successor's data and the successor is unlinked instead.
+     * Ancestors are updated, and rebalanced in Balance::AVL mode, on the way back up.
+     * @param path Nodes from the root to the node to remove.
+     * @pre The tree's nodes are not shared.
+     */
+    void removeNode(std::vector<BinNode*>&);
+    /**
+     * @brief Finds the nodes from the root to a value, without modifying the tree.
+     * @param nd Value to search for.
+     * @param path Receives the nodes, ending with the one holding 'nd'.
+     * @return false If the value is not in the tree.
+     */
+    bool findPath(const NodeData&, std::vector<BinNode*>&) const;
+    /**
+     * @brief Lists the tree's values in sorted order without copying them.
+     * @details In-order for ordered trees, unordered trees are sorted in O(n log n).
+     */
+    void sortedValues(std::vector<const NodeData*>&) const;
+    /**
+     * @brief Merges the sorted values of two trees into a new balanced tree.
+     * @param keepLeft Keep values only in this tree.
+     * @param keepBoth Keep values in both trees.
+     * @param keepRight Keep values only in 'bst'.
+     */
+    BinTree merge(const BinTree&, bool, bool, bool) const;
+    /**
+     * @brief Empties the tree, moving its NodeData out in sorted order.
+     * @param out Receives the NodeData.
+     * @pre The tree's nodes are not shared.
+     * @post root == nullptr
+     */
+    void release(std::vector<NodeData*>&);
+    /**
+     * @brief Ensures this tree exclusively owns its nodes before it is modified.
+     * @details Nodes shared with a copy-on-write copy are cloned first.
+     * @post pool != nullptr and is not shared.
+     */
+    void detach();
+    /**
+     * @brief Duplicates the shape and data of a subtree into a single block of 'pool'.
+     * @details 
+     * With more than one thread, the subtrees below the top levels are counted and cloned
+     * in parallel into disjoint ranges of the block.
+     * @param src Root of the subtree to copy.
+     * @param count Number of nodes in the subtree.
+     * @param pool Pool that owns the copy.
+     * @param threads Number of threads to use.
+     * @return BinNode* Root of the copy, nullptr if 'src' is nullptr.
+     */
+    static BinNode* clone(const BinNode*, size_t, NodePool&, unsigned);
+    /**
+     * @brief Sequentially copies a subtree in pre-order into consecutive nodes of 'block'.
+     * @pre 'block' has room for every node of the subtree.
+     * @return BinNode* Root of the copy.
+     */
+    static BinNode* cloneInto(const BinNode*, BinNode*);
+    /**
+     * @brief Builds a balanced subtree for nd[begin, end) rooted at the midpoint.
+     * @details Element i is stored in block[i]. Halves are built on separate threads while 'threads' > 1.
+     * @return BinNode* Root of the subtree, nullptr if the range is empty.
+     */
+    static BinNode* buildBalanced(BinNode*, NodeData* const*, size_t, size_t, unsigned);
+    /**
+     * @brief Keeps the first of each run of equal neighbours in 'nd' and deletes the rest.
+     * @param extra If not nullptr, receives the number of values deleted after each kept value.
+     */
+    static void foldRepeats(std::vector<NodeData*>&, std::vector<size_t>*);
+    /**
+     * @brief Counts values less than 'nd', or less than or equal to it if 'inclusive'.
+     */
+    size_t countBelow(const NodeData&, bool) const;
+    /**
+     * @brief Positions an iterator at the first value >= 'nd', or > 'nd' if 'strict'.
+     */
+    Iterator bound(const NodeData&, bool) const;
+
+    /* Node Helpers */
+
+    /**
+     * @brief Returns the cached height of a node, 0 for nullptr.
+     */
+    static int height(const BinNode*);
+    /**
+     * @brief Returns the cached subtree hash of a node, 0 for nullptr.
+     */
+    static size_t hash(const BinNode*);
+    /**
+     * @brief Returns the cached subtree size of a node, 0 for nullptr.
+     */
+    static size_t subtreeSize(const BinNode*);
+    /**
+     * @brief Recomputes a node's cached height, size and subtree hash from its children.
+     * @details The hash combines left, value and right asymmetrically so it reflects shape.
+     */
+    static void updateNode(BinNode*);
+    /**
+     * @brief Describes BinNode links to the rotations in avl.h.
+     */
+    struct Links;
+    /**
+     * @brief Restores the AVL property at 'cur' and updates its height.
+     * @pre Both subtrees of 'cur' are AVL trees whose heights differ by at most 2.
+     */
+    static void rebalance(BinNode*&);
 
 public:
 
@@ -43,10 +285,23 @@ public:
      * @brief Creates an empty binary tree.
      */
     BinTree();
+    /**
+     * @brief Creates an empty binary tree with a balancing strategy.
+     * @param balance Balance::AVL keeps insert and retrieve at O(log n) depth.
+     */
+    explicit BinTree(Balance);
     /**
      * @brief Creates a Deep Copy
+     * @details 
+     * The copy uses the same balancing strategy and shape as the original.
+     * Nodes are cloned structurally in O(n), no comparisons are made.
      */
     BinTree(const BinTree&);
+    /**
+     * @brief Takes the contents of another tree in O(1).
+     * @post 'bst' is empty.
+     */
+    BinTree(BinTree&&) noexcept;
     /**
      * @brief Destroys the BST.
      */
@@ -57,14 +312,25 @@ public:
     // Assignment
     /**
      * @brief Assigns the BST.
+     * @details 
+     * The balancing strategy and shape of 'bst' are copied.
+     * Nodes are cloned structurally in O(n), no comparisons are made.
      * @param bst BST to assign.
      * @return A reference to this BST. 
      */
     BinTree& operator=(const BinTree&);
+    /**
+     * @brief Takes the contents of another tree in O(1).
+     * @post 'bst' is empty.
+     */
+    BinTree& operator=(BinTree&&) noexcept;
 
     // Equivalence 
     /**
      * @brief Checks for BST Equivalence.
+     * @details 
+     * Trees with a different size or root hash are rejected in O(1).
+     * Otherwise nodes are compared until the first mismatch.
      * @param bst BST to assign.
      * @return true If 'bst' is equivalent to this tree.
      * @return false If 'bst' is not equivalent to this tree.
@@ -91,46 +357,140 @@ public:
      * @param value - Value to search for in tree.
      * @param ptr - Pointer to 'value'.
      * @post If false is returned 'ptr' is a nullptr.
+     * @note If the tree is shared, 'ptr' is also seen by its copy-on-write copies.
      * @return true If the value is in the tree
      * @return false If the value is not in the tree.
      */
     bool retrieve(const NodeData&, NodeData*&);
+    /**
+     * @brief Returns a pointer by reference to the value equal to a raw key.
+     * @details Accepts anything viewable as a string, no NodeData is built to search.
+     * @param key - Key to search for in tree.
+     * @param ptr - Pointer to the matching value.
+     * @post If false is returned 'ptr' is a nullptr.
+     * @return true If the key is in the tree
+     * @return false If the key is not in the tree.
+     */
+    template<class Key, std::enable_if_t<std::is_convertible_v<const Key&, std::string_view>, int> = 0>
+    bool retrieve(const Key& key, NodeData*& out) {
+        BinNode* node = this->findNode(std::string_view(key));
+        out = node == nullptr ? nullptr : node->data;
+        return node != nullptr;
+    }
 
     /* Mutators */
 
     /**
      * @brief Inserts a Node into the BST.
+     * @details In Balance::AVL mode the tree is rebalanced on the way back up.
      * @pre NodeData is dynamically allocated.
-     * @return true If node was successfully inserted into the Tree.
+     * @return true If node was successfully inserted into the Tree, or counted as a duplicate.
      * @return false If the node was not successfully inserted into the tree (duplicate value)
      */
     bool insert(NodeData*);
+    /**
+     * @brief Builds a NodeData from a raw key in place and inserts it.
+     * @details 
+     * The tree is searched with the raw key first, so duplicates allocate nothing.
+     * A std::string rvalue is moved into the NodeData, any other key is copied once.
+     * @param key Key to insert.
+     * @return true If the key was inserted, or counted as a duplicate.
+     * @return false If the key was a duplicate.
+     */
+    template<class Key, std::enable_if_t<std::is_convertible_v<const Key&, std::string_view>, int> = 0>
+    bool emplace(Key&& key) {
+        std::vector<BinNode**> path;
+        BinNode** link = this->findLink(std::string_view(key), path);
+        if(link == nullptr) return this->counting;
+        this->linkNode(link, path, new NodeData(std::string(std::forward<Key>(key))));
+        return true;
+    }
+    /**
+     * @brief Removes a value from the BST and deletes its NodeData.
+     * @details 
+     * O(height) on ordered trees, the tree is rebalanced in Balance::AVL mode.
+     * The freed node is recycled by later inserts.
+     * @return true If the value was found and removed.
+     * @return false If the value is not in the tree.
+     */
+    bool remove(const NodeData&);
+    /**
+     * @brief Removes every listed value that is in the BST.
+     * @return size_t Number of values removed.
+     */
+    size_t remove(const std::vector<NodeData>&);
     /**
      * @brief Fills an array with BST data and empties the tree.
      * @param data Array of Data values from tree.
      * @post BST is empty. 
      */
     void bstreeToArray(NodeData*[]);
+    /**
+     * @brief Moves the BST data into a vector in sorted order and empties the tree.
+     * @details Ownership of the NodeData is transferred, nothing is copied.
+     * @param data Replaced with the Data values from the tree.
+     * @post BST is empty. 
+     */
+    void bstreeToArray(std::vector<NodeData*>&);
     /**
      * @brief Fills a BST with array data and empties the array.
-     * @param data Array of Data values to insert.
+     * @param data Array of Data values to insert, terminated by nullptr or 100 elements.
      * @pre 'data' is not empty.
+     * @post Previous contents of the BST are discarded.
+     * @post isOrdered() is false if 'data' was not sorted or repeats a value.
      */
     void arrayToBSTree(NodeData*[]);
+    /**
+     * @brief Builds a perfectly balanced BST from vector data and empties the vector.
+     * @details 
+     * Each subtree is rooted at the midpoint of its index range, so the build is O(n).
+     * Ownership of the NodeData is transferred, nothing is copied.
+     * @param data Data values to insert, expected to be sorted.
+     * @post Previous contents of the BST are discarded.
+     * @post isOrdered() is false if 'data' was not sorted or repeats a value.
+     */
+    void arrayToBSTree(std::vector<NodeData*>&);
+    /**
+     * @brief Builds a balanced BST from unsorted vector data using multiple threads.
+     * @details 
+     * The data is sorted in parallel and duplicates are deleted, or counted if counting,
+     * then the halves of the tree are built on separate threads.
+     * Ownership of the remaining NodeData is transferred.
+     * @param data Data values to insert, in any order.
+     * @post Previous contents of the BST are discarded.
+     * @post 'data' is empty.
+     */
+    void bulkLoad(std::vector<NodeData*>&);
     /**
      * @brief Empties the BST.
+     * @details Large trees delete their data on multiple threads, see setParallelism().
      * @post isEmpty() == true
      */
     void makeEmpty();
+    /**
+     * @brief Sets the number of threads used by bulkLoad(), copying and makeEmpty().
+     * @details Trees smaller than a cutoff are always processed on the calling thread.
+     * @param threads 0 selects the hardware concurrency, 1 (the default) disables threading.
+     */
+    void setParallelism(unsigned);
+    /**
+     * @brief Returns the number of threads used by whole-tree operations.
+     */
+    unsigned getParallelism() const;
 
     /* Auxilary Functions */
 
    /**
      * @brief Returns the height of a specific value in the tree.
-     * 
-     * @return int 
+     * @details Heights are cached in every node, so this costs only the lookup.
+     * @return int Levels in the value's subtree, 0 if the value is not in the tree.
      */
     int getHeight(const NodeData&) const;
+    /**
+     * @brief Lists every value with its height in sorted order, in O(n).
+     * @param heights Replaced with (value, height) pairs.
+     */
+    void getHeights(std::vector<std::pair<const NodeData*, int>>&) const;
     // int getDepth(const NodeData&) const; // OPTIONAL
     /**
      * @brief Determines if the BST is empty.
@@ -138,10 +498,354 @@ public:
      * @return false If root != nullptr
      */
     bool isEmpty() const;
+    /**
+     * @brief Returns the number of values in the tree in O(1).
+     */
+    size_t size() const;
+    /**
+     * @brief Determines if the tree satisfies the BST ordering.
+     * @details Only arrayToBSTree() given unsorted or repeated data produces an unordered tree.
+     * @return true If lookups can follow BST ordering.
+     * @return false If lookups must scan the whole tree.
+     */
+    bool isOrdered() const;
+    /**
+     * @brief Creates a copy-on-write copy of the tree in O(1).
+     * @details 
+     * Both trees share nodes until either is modified, which then clones the nodes first.
+     * Read-only copies of large trees therefore cost nothing.
+     * @return BinTree Copy sharing this tree's nodes.
+     */
+    BinTree share() const;
+    /**
+     * @brief Determines if the tree's nodes are shared with a copy-on-write copy.
+     */
+    bool isShared() const;
+    /**
+     * @brief Snapshot of the tree's shape, memory use and operation counts.
+     * @details 
+     * Shape and memory figures are measured when getStats() is called.
+     * Operation counts are only collected when compiled with -DBINTREE_STATS, otherwise they
+     * are zero and 'counted' is false.
+     */
+    struct Stats {
+        bool counted; // Whether the operation counts below were collected
+        // A comparison is counted for every node whose key is compared with the search key
+        uint64_t inserts, insertComparisons; // Includes emplace()
+        uint64_t lookups, lookupComparisons; // retrieve() and getHeight(const NodeData&)
+        size_t size;
+        int height;
+        int optimalHeight; // Height of a perfectly balanced tree of the same size
+        double imbalance; // height / optimalHeight, 1 is perfectly balanced
+        std::vector<size_t> depths; // depths[d] is the number of nodes at depth d, the root is 0
+        size_t nodeBlocks, nodeBytes; // Node pool blocks, shared with copy-on-write copies
+        size_t payloads, payloadBytes; // NodeData objects and the characters they hold
+        /**
+         * @brief Writes the stats as a single JSON object.
+         */
+        void writeJson(std::ostream&) const;
+    };
+    /**
+     * @brief Measures the tree and collects its operation counts, O(n).
+     */
+    Stats getStats() const;
     /**
      * @brief Displays a sideways diagram of the tree to the console.
      */
     void displaySideways() const;
+    /**
+     * @brief Writes a sideways diagram of the tree to a stream.
+     * @details 
+     * Lines are rendered into a buffer that is written in large chunks, the stream is not flushed.
+     * With a depth limit, each subtree below the limit is drawn as a single "... (n)" line
+     * giving its number of values, so huge trees can be inspected near the root.
+     * @param os Stream to write to.
+     * @param maxDepth Deepest level drawn, the root is level 1. 0 draws every level.
+     */
+    void displaySideways(std::ostream&, int = 0) const;
+
+    /* Iteration */
+
+    /**
+     * @brief Bidirectional in-order iterator over the values in the tree.
+     * @details
+     * Holds the path from the root to the current node instead of relying on parent pointers,
+     * so traversal never recurses. Any modification of the tree invalidates its iterators.
+     */
+    class Iterator {
+
+        friend class BinTree;
+
+    public:
+
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = NodeData;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const NodeData*;
+        using reference = const NodeData&;
+
+        /**
+         * @brief Creates an iterator that is not attached to any tree.
+         */
+        Iterator();
+
+        reference operator*() const;
+        pointer operator->() const;
+        /**
+         * @brief Advances to the in-order successor.
+         * @pre Iterator is not end().
+         */
+        Iterator& operator++();
+        Iterator operator++(int);
+        /**
+         * @brief Moves to the in-order predecessor, end() moves to the largest value.
+         * @pre Iterator is not begin().
+         */
+        Iterator& operator--();
+        Iterator operator--(int);
+        bool operator==(const Iterator&) const;
+        bool operator!=(const Iterator&) const;
+
+    private:
+
+        const BinTree* tree;
+        std::vector<const BinNode*> path; // Root to current node, empty at end()
+
+        explicit Iterator(const BinTree*);
+        /**
+         * @brief Pushes 'cur' and its chain of left children onto the path.
+         */
+        void pushLeftmost(const BinNode*);
+        /**
+         * @brief Pushes 'cur' and its chain of right children onto the path.
+         */
+        void pushRightmost(const BinNode*);
+
+    };
+
+    /**
+     * @brief Returns an iterator to the smallest value in the tree.
+     */
+    Iterator begin() const;
+    /**
+     * @brief Returns the past-the-end iterator.
+     */
+    Iterator end() const;
+
+    /* Order Statistics */
+
+    /**
+     * @brief Values in [lo, hi] as an iterable range, the tree is not modified.
+     */
+    struct Range {
+        Iterator first, last;
+        Iterator begin() const { return first; }
+        Iterator end() const { return last; }
+    };
+
+    /**
+     * @brief Returns the number of values in the tree less than 'nd' in O(height).
+     * @pre isOrdered()
+     */
+    size_t rank(const NodeData&) const;
+    /**
+     * @brief Returns the k-th smallest value in O(height).
+     * @param k Zero-based position in sorted order.
+     * @return nullptr If k >= size()
+     */
+    const NodeData* select(size_t) const;
+    /**
+     * @brief Counts the values in [lo, hi] in O(height).
+     * @pre isOrdered()
+     */
+    size_t countRange(const NodeData&, const NodeData&) const;
+    /**
+     * @brief Returns an iterator to the first value not less than 'nd', or end().
+     * @pre isOrdered()
+     */
+    Iterator lowerBound(const NodeData&) const;
+    /**
+     * @brief Returns an iterator to the first value greater than 'nd', or end().
+     * @pre isOrdered()
+     */
+    Iterator upperBound(const NodeData&) const;
+    /**
+     * @brief Returns the values in [lo, hi] for iteration in O(height + output).
+     * @pre isOrdered()
+     */
+    Range range(const NodeData&, const NodeData&) const;
+
+    /* Counting */
+
+    /**
+     * @brief Switches between rejecting duplicates and counting them.
+     * @details 
+     * When counting, inserting a value already in the tree adds one to its count and deletes
+     * the duplicate NodeData, emplace() of a duplicate allocates nothing, and remove() takes
+     * away one occurrence at a time. Trees with different counts are not equal.
+     * bulkLoad() counts every repeated value, arrayToBSTree() counts repeats that are neighbours.
+     * Counts are not kept by bstreeToArray(), set algebra or snapshots.
+     * @param counting Whether duplicates are counted.
+     */
+    void setCounting(bool);
+    /**
+     * @brief Determines if duplicates are counted, see setCounting().
+     */
+    bool isCounting() const;
+    /**
+     * @brief Returns the number of occurrences of a value, 0 if it is not in the tree.
+     */
+    size_t count(const NodeData&) const;
+    /**
+     * @brief Lists the k most frequent values in O(n log k).
+     * @param k Number of values wanted.
+     * @param top Replaced with (value, count) pairs, most frequent first, ties in sorted order.
+     */
+    void topK(size_t, std::vector<std::pair<const NodeData*, size_t>>&) const;
+    /**
+     * @brief Prints the values in sorted order, each as value:count.
+     */
+    void displayCounts(std::ostream&) const;
+
+    /* Set Algebra */
+
+    /**
+     * @brief Returns the values in either tree.
+     * @details 
+     * Both trees are walked in order and merged in O(n + m), the result is built balanced
+     * from copies of the values, in this tree's Balance mode. Unordered trees are sorted first.
+     */
+    BinTree setUnion(const BinTree&) const;
+    /**
+     * @brief Returns the values in both trees, see setUnion().
+     */
+    BinTree intersection(const BinTree&) const;
+    /**
+     * @brief Returns the values in this tree that are not in 'bst', see setUnion().
+     */
+    BinTree difference(const BinTree&) const;
+    /**
+     * @brief Determines if every value in this tree is in 'bst' in O(n + m).
+     */
+    bool isSubset(const BinTree&) const;
+
+    /* Loading */
+
+    /**
+     * @brief Reads whitespace separated tokens into trees, one tree per "$$" terminated section.
+     * @details
+     * The stream is read in large blocks and tokens are viewed in place, a token is only
+     * copied once, into its NodeData, and duplicates are rejected without allocating.
+     * Tokens are inserted in file order, so trees have the same shape as when built
+     * one insert at a time.
+     */
+    class Loader {
+    public:
+        /**
+         * @brief Reads from 'in', 'blockSize' bytes at a time.
+         */
+        explicit Loader(std::istream&, size_t = 1 << 16);
+        /**
+         * @brief Inserts the tokens of the next section into 'tree'.
+         * @details A section ends at "$$" or at the end of the stream.
+         * @return true If a section was read, it may have been empty.
+         * @return false If the stream had no more tokens.
+         */
+        bool next(BinTree&);
+    private:
+        std::istream& in;
+        std::vector<char> buffer;
+        size_t begin, end; // Unread bytes are buffer[begin, end)
+        /**
+         * @brief Keeps the unread bytes and reads the next block after them.
+         * @details The buffer doubles if a single token fills it.
+         * @return false If nothing more could be read.
+         */
+        bool refill();
+    };
+
+    /**
+     * @brief Builds one tree for every section of a stream in a single pass.
+     * @param in Stream of "$$" terminated sections.
+     * @param trees Trees are appended for each section.
+     * @param balance Balancing strategy of the new trees.
+     * @return size_t Number of trees appended.
+     */
+    static size_t loadAll(std::istream&, std::vector<BinTree>&, Balance = Balance::None);
+
+    /* Snapshots */
+
+    /**
+     * @brief Read-only view of a file written by save(), memory-mapped rather than read.
+     * @details
+     * The file holds a header, the byte offset of every key, the tree's shape and then every
+     * key in in-order. Keys of an ordered tree are looked up by binary search directly in the
+     * mapping, opening only checks that the offsets and shape are consistent, nothing is copied.
+     * Offsets are in the host's byte order, snapshots are not portable between architectures.
+     */
+    class Snapshot {
+    public:
+        /**
+         * @brief Maps a snapshot file, check isOpen() for success.
+         */
+        explicit Snapshot(const std::string&);
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        /**
+         * @brief Unmaps the file.
+         */
+        ~Snapshot();
+        /**
+         * @brief Determines if the file was mapped and has a valid header.
+         */
+        bool isOpen() const;
+        /**
+         * @brief Returns the number of keys.
+         */
+        size_t size() const;
+        /**
+         * @brief Returns the k-th key in in-order, valid while the snapshot is open.
+         * @pre k < size()
+         */
+        std::string_view operator[](size_t) const;
+        /**
+         * @brief Determines if a key is in the snapshot in O(log n).
+         * @details Unordered trees are scanned linearly.
+         */
+        bool contains(std::string_view) const;
+    private:
+        friend class BinTree;
+        struct Header {
+            char magic[8];
+            uint64_t count; // Number of keys
+            uint64_t blobBytes; // Total length of the keys
+            uint64_t ordered; // Whether the keys are sorted
+        };
+        const char* map; // nullptr if the file could not be mapped
+        size_t length;
+        const Header* header;
+        const uint64_t* offsets; // count + 1 offsets into 'blob'
+        const unsigned char* shape; // 2 bits per node in pre-order, see save()
+        const char* blob;
+    };
+
+    /**
+     * @brief Writes the tree to a snapshot file.
+     * @details The keys are written in order, followed by whether each node has a left and right child in pre-order.
+     * @return true If the file was written.
+     */
+    bool save(const std::string&) const;
+    /**
+     * @brief Replaces the tree with the contents of a snapshot file.
+     * @return true If the file was a valid snapshot.
+     */
+    bool load(const std::string&);
+    /**
+     * @brief Replaces the tree with the contents of a snapshot in O(n).
+     * @details The saved shape is rebuilt node for node, no keys are compared.
+     * @pre snapshot.isOpen()
+     */
+    void load(const Snapshot&);
 
 };
 
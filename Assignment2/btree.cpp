@@ -0,0 +1,235 @@
+/**
+ * @file btree.cpp
+ * @author haydenlauritzen@gmail.com
+ * @brief Implementation file for BTree
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2022
+ */
+
+#include"btree.h"
+#include<utility>
+
+/*** Constructors ***/
+
+BTree::BTree() {
+    this->root = nullptr;
+    this->count = 0;
+}
+
+BTree::~BTree() {
+    this->makeEmpty();
+}
+
+/* Accessors */
+
+bool BTree::retrieve(const NodeData& nd, NodeData*& out) const {
+    const BNode* cur = this->root;
+    while(cur != nullptr) {
+        int i = lowerBound(cur, nd);
+        if(i < cur->numKeys && *(cur->keys[i]) == nd) {
+            out = cur->keys[i];
+            return true;
+        }
+        // Keys in children[i] lie between keys[i-1] and keys[i]
+        cur = cur->leaf ? nullptr : cur->children[i];
+    }
+    out = nullptr;
+    return false;
+}
+
+/* Mutators */
+
+bool BTree::insert(NodeData* nd) {
+    if(this->root == nullptr) {
+        this->root = new BNode();
+        this->root->leaf = true;
+    }
+    // Duplicates are rejected before any node is split
+    NodeData* existing;
+    if(this->retrieve(*nd, existing)) return false;
+    if(this->root->numKeys == MAXKEYS) {
+        // Tree grows in height only at the root
+        BNode* newRoot = new BNode();
+        newRoot->leaf = false;
+        newRoot->children[0] = this->root;
+        this->root = newRoot;
+        splitChild(newRoot, 0);
+    }
+    BNode* cur = this->root;
+    while(!cur->leaf) {
+        int i = lowerBound(cur, *nd);
+        if(cur->children[i]->numKeys == MAXKEYS) {
+            splitChild(cur, i);
+            // The median moved up into keys[i], go right of it if larger
+            if(*nd > *(cur->keys[i])) ++i;
+        }
+        cur = cur->children[i];
+    }
+    int i = lowerBound(cur, *nd);
+    for(int j = cur->numKeys; j > i; --j) {
+        cur->keys[j] = cur->keys[j-1];
+    }
+    cur->keys[i] = nd;
+    ++cur->numKeys;
+    ++this->count;
+    return true;
+}
+
+void BTree::bstreeToArray(NodeData* nd[]) {
+    std::vector<NodeData*> data;
+    this->bstreeToArray(data);
+    // Array is assumed to handle ownership of values
+    for(size_t i = 0; i < data.size(); i++) {
+        nd[i] = data[i];
+    }
+}
+
+void BTree::bstreeToArray(std::vector<NodeData*>& nd) {
+    nd.clear();
+    nd.reserve(this->count);
+    // In-order traversal, each node is paired with the index of the next child to visit
+    std::vector<std::pair<const BNode*, int>> stack;
+    if(this->root != nullptr) stack.emplace_back(this->root, 0);
+    while(!stack.empty()) {
+        auto& [cur, i] = stack.back();
+        if(cur->leaf) {
+            nd.insert(nd.end(), cur->keys, cur->keys + cur->numKeys);
+            stack.pop_back();
+        }
+        else if(i <= cur->numKeys) {
+            // keys[i-1] lies between children i-1 and i
+            if(i > 0) nd.push_back(cur->keys[i-1]);
+            const BNode* child = cur->children[i];
+            ++i;
+            stack.emplace_back(child, 0);
+        }
+        else {
+            stack.pop_back();
+        }
+    }
+    this->destroy(false); // Tree should be empty; values are owned by 'nd'
+}
+
+void BTree::makeEmpty() {
+    this->destroy(true);
+}
+
+void BTree::destroy(bool deleteData) {
+    std::vector<BNode*> stack;
+    if(this->root != nullptr) stack.push_back(this->root);
+    while(!stack.empty()) {
+        BNode* cur = stack.back();
+        stack.pop_back();
+        if(deleteData) {
+            for(int i = 0; i < cur->numKeys; i++) {
+                delete cur->keys[i];
+            }
+        }
+        if(!cur->leaf) {
+            for(int i = 0; i <= cur->numKeys; i++) {
+                stack.push_back(cur->children[i]);
+            }
+        }
+        delete cur;
+    }
+    this->root = nullptr;
+    this->count = 0;
+}
+
+/* Auxilary Functions */
+
+int BTree::lowerBound(const BNode* cur, const NodeData& nd) {
+    int low = 0, high = cur->numKeys;
+    while(low < high) {
+        int mid = (low + high) / 2;
+        if(*(cur->keys[mid]) < nd) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void BTree::splitChild(BNode* parent, int index) {
+    /*
+     * child: [k0 .. k(D-2)] k(D-1) [kD .. k(2D-2)]
+     *        stays in child  moves up  moves to sibling
+     */
+    BNode* child = parent->children[index];
+    BNode* sibling = new BNode();
+    sibling->leaf = child->leaf;
+    sibling->numKeys = DEGREE - 1;
+    for(int i = 0; i < DEGREE - 1; i++) {
+        sibling->keys[i] = child->keys[DEGREE + i];
+    }
+    if(!child->leaf) {
+        for(int i = 0; i < DEGREE; i++) {
+            sibling->children[i] = child->children[DEGREE + i];
+        }
+    }
+    child->numKeys = DEGREE - 1;
+    // Make room in the parent for the median and the new sibling
+    for(int i = parent->numKeys; i > index; --i) {
+        parent->keys[i] = parent->keys[i-1];
+        parent->children[i+1] = parent->children[i];
+    }
+    parent->keys[index] = child->keys[DEGREE - 1];
+    parent->children[index+1] = sibling;
+    ++parent->numKeys;
+}
+
+bool BTree::isEmpty() const {
+    return this->count == 0;
+}
+
+size_t BTree::size() const {
+    return this->count;
+}
+
+int BTree::getHeight() const {
+    int height = 0;
+    // Every leaf is at the same depth
+    for(const BNode* cur = this->root; cur != nullptr; cur = cur->leaf ? nullptr : cur->children[0]) {
+        ++height;
+    }
+    return height;
+}
+
+std::ostream& operator<<(std::ostream& os, const BTree& bt) {
+    bool first = true;
+    // In-order traversal, each node is paired with the index of the next child to visit
+    std::vector<std::pair<const BTree::BNode*, int>> stack;
+    if(bt.root != nullptr && bt.root->numKeys > 0) stack.emplace_back(bt.root, 0);
+    auto print = [&](const NodeData* nd) {
+        if(!first) {
+            os << " ";
+        }
+        else {
+            first = false;
+        }
+        os << *nd;
+    };
+    while(!stack.empty()) {
+        auto& [cur, i] = stack.back();
+        if(cur->leaf) {
+            for(int k = 0; k < cur->numKeys; k++) {
+                print(cur->keys[k]);
+            }
+            stack.pop_back();
+        }
+        else if(i <= cur->numKeys) {
+            // keys[i-1] lies between children i-1 and i
+            if(i > 0) print(cur->keys[i-1]);
+            const BTree::BNode* child = cur->children[i];
+            ++i;
+            stack.emplace_back(child, 0);
+        }
+        else {
+            stack.pop_back();
+        }
+    }
+    os << std::endl;
+    return os;
+}
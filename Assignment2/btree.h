@@ -0,0 +1,128 @@
+/**
+ * @file btree.h
+ * @author haydenlauritzen@gmail.com
+ * @brief Header file for BTree
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2022
+ */
+
+#pragma once
+
+#include<iostream>
+#include<vector>
+#include"nodedata.h"
+
+/**
+ * @brief Ordered set of NodeData with the BinTree interface, stored as a B-tree.
+ * @details
+ * Each node holds up to 2*DEGREE-1 sorted keys, so a lookup touches about log_DEGREE(n) nodes
+ * instead of log_2(n), and the keys of a node are searched within one contiguous array.
+ */
+class BTree {
+
+    /**
+     * @brief Prints the values in sorted order.
+     * @return ostream&
+     */
+    friend std::ostream& operator<<(std::ostream&, const BTree&);
+
+private:
+
+    static const int DEGREE = 16; // Minimum degree, non-root nodes hold DEGREE-1 to 2*DEGREE-1 keys
+    static const int MAXKEYS = 2 * DEGREE - 1;
+
+    struct BNode {
+        int numKeys;
+        bool leaf;
+        NodeData* keys[MAXKEYS];
+        BNode* children[MAXKEYS + 1];
+    };
+
+    BNode* root;
+    size_t count; // Number of keys in the tree
+
+    /**
+     * @brief Finds the first key in a node that is not less than 'nd'.
+     * @return int Index in [0, numKeys]
+     */
+    static int lowerBound(const BNode*, const NodeData&);
+    /**
+     * @brief Splits the full child 'index' of 'parent' around its median key.
+     * @pre 'parent' is not full.
+     */
+    static void splitChild(BNode*, int);
+    /**
+     * @brief Frees every node.
+     * @param deleteData Whether the NodeData is deleted as well.
+     */
+    void destroy(bool);
+
+public:
+
+    /* Constructors */
+    /**
+     * @brief Creates an empty B-tree.
+     */
+    BTree();
+    BTree(const BTree&) = delete;
+    BTree& operator=(const BTree&) = delete;
+    /**
+     * @brief Destroys the B-tree.
+     */
+    ~BTree();
+
+    /* Accessors */
+
+    /**
+     * @brief Returns a pointer by reference of a specific value in the tree.
+     * @param value - Value to search for in tree.
+     * @param ptr - Pointer to 'value'.
+     * @return true If the value is in the tree
+     * @return false If the value is not in the tree.
+     */
+    bool retrieve(const NodeData&, NodeData*&) const;
+
+    /* Mutators */
+
+    /**
+     * @brief Inserts a value into the tree.
+     * @details Full nodes are split on the way down, so insertion never backtracks.
+     * @pre NodeData is dynamically allocated.
+     * @return true If the value was inserted, the tree takes ownership.
+     * @return false If the value is a duplicate, the caller keeps ownership.
+     */
+    bool insert(NodeData*);
+    /**
+     * @brief Fills an array with the tree's data in sorted order and empties the tree.
+     * @param data Array of Data values from tree.
+     * @post Tree is empty.
+     */
+    void bstreeToArray(NodeData*[]);
+    /**
+     * @brief Moves the tree's data into a vector in sorted order and empties the tree.
+     * @param data Replaced with the Data values from the tree.
+     * @post Tree is empty.
+     */
+    void bstreeToArray(std::vector<NodeData*>&);
+    /**
+     * @brief Empties the tree.
+     * @post isEmpty() == true
+     */
+    void makeEmpty();
+
+    /* Auxilary Functions */
+
+    /**
+     * @brief Determines if the tree is empty.
+     */
+    bool isEmpty() const;
+    /**
+     * @brief Returns the number of values in the tree.
+     */
+    size_t size() const;
+    /**
+     * @brief Returns the number of node levels, 0 if empty.
+     */
+    int getHeight() const;
+
+};
@@ -0,0 +1,225 @@
+/**
+ * @file concurrentbintree.cpp
+ * @author haydenlauritzen@gmail.com
+ * @brief Implementation file for ConcurrentBinTree
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2022
+ */
+
+#include"concurrentbintree.h"
+#include"avl.h"
+#include<stdexcept>
+
+ConcurrentBinTree::ReaderSlot ConcurrentBinTree::readers[ConcurrentBinTree::MAXREADERS];
+std::atomic<uint64_t> ConcurrentBinTree::globalEpoch{1};
+
+namespace {
+
+    // Reader slot claimed by the current thread, released when the thread exits
+    struct ThreadSlot {
+        std::atomic<bool>* claimed = nullptr;
+        std::atomic<uint64_t>* epoch = nullptr;
+        ~ThreadSlot() {
+            if(this->claimed != nullptr) this->claimed->store(false);
+        }
+    };
+    thread_local ThreadSlot threadSlot;
+
+}
+
+/*** Constructors ***/
+
+ConcurrentBinTree::ConcurrentBinTree() : root(nullptr), count(0) {}
+
+ConcurrentBinTree::~ConcurrentBinTree() {
+    std::vector<CNode*> stack;
+    if(this->root.load() != nullptr) stack.push_back(this->root.load());
+    while(!stack.empty()) {
+        CNode* cur = stack.back();
+        stack.pop_back();
+        if(cur->left != nullptr) stack.push_back(cur->left);
+        if(cur->right != nullptr) stack.push_back(cur->right);
+        delete cur->data;
+        delete cur;
+    }
+    // Retired nodes shared their data with the live tree
+    for(Retired& batch : this->retired) {
+        for(CNode* node : batch.nodes) delete node;
+    }
+}
+
+/* Read Guard */
+
+ConcurrentBinTree::ReadGuard::ReadGuard() {
+    if(threadSlot.epoch == nullptr) {
+        for(ReaderSlot& reader : readers) {
+            bool expected = false;
+            if(reader.claimed.compare_exchange_strong(expected, true)) {
+                threadSlot.claimed = &reader.claimed;
+                threadSlot.epoch = &reader.epoch;
+                break;
+            }
+        }
+        if(threadSlot.epoch == nullptr) {
+            throw std::runtime_error("ConcurrentBinTree: too many reader threads");
+        }
+    }
+    // Nested guards on the same thread keep the outer guard's epoch
+    if(threadSlot.epoch->load(std::memory_order_relaxed) == IDLE) {
+        this->slot = threadSlot.epoch;
+        this->slot->store(globalEpoch.load());
+    }
+    else {
+        this->slot = nullptr;
+    }
+}
+
+ConcurrentBinTree::ReadGuard::~ReadGuard() {
+    if(this->slot != nullptr) this->slot->store(IDLE);
+}
+
+/* Accessors */
+
+bool ConcurrentBinTree::retrieve(const NodeData& nd, NodeData*& out) const {
+    ReadGuard guard;
+    const CNode* cur = this->root.load();
+    while(cur != nullptr) {
+        if(nd < *(cur->data)) {
+            cur = cur->left;
+        }
+        else if(nd > *(cur->data)) {
+            cur = cur->right;
+        }
+        else {
+            out = cur->data;
+            return true;
+        }
+    }
+    out = nullptr;
+    return false;
+}
+
+size_t ConcurrentBinTree::size() const {
+    return this->count.load();
+}
+
+bool ConcurrentBinTree::isEmpty() const {
+    return this->size() == 0;
+}
+
+/* Mutators */
+
+bool ConcurrentBinTree::insert(NodeData* nd) {
+    std::lock_guard<std::mutex> lock(this->writeLock);
+    // Writers are serialized, so the published tree cannot change under us
+    std::vector<CNode*> replaced;
+    std::vector<CNode**> path;
+    CNode* oldRoot = this->root.load();
+    CNode* newRoot = nullptr;
+    CNode** link = &newRoot;
+    for(CNode* cur = oldRoot; cur != nullptr; ) {
+        if(*nd == *(cur->data)) {
+            // Duplicate, discard the unpublished copies
+            // Each link lives inside the previous copy, so the copies are freed deepest first
+            while(!path.empty()) {
+                delete *path.back();
+                path.pop_back();
+            }
+            return false;
+        }
+        // Copy the node, the copy can be modified until it is published
+        CNode* copy = new CNode(*cur);
+        *link = copy;
+        path.push_back(link);
+        replaced.push_back(cur);
+        if(*nd < *(cur->data)) {
+            link = &copy->left;
+            cur = cur->left;
+        }
+        else {
+            link = &copy->right;
+            cur = cur->right;
+        }
+    }
+    *link = new CNode{nullptr, nullptr, nd, 1};
+    // Every node on the path is a private copy, so rotations only touch unpublished nodes
+    while(!path.empty()) {
+        rebalance(*path.back());
+        path.pop_back();
+    }
+    this->root.store(newRoot);
+    ++this->count;
+    // Readers that started before this point may still be on the replaced nodes
+    uint64_t epoch = globalEpoch.fetch_add(1);
+    if(!replaced.empty()) this->retired.push_back({epoch, std::move(replaced)});
+    this->reclaim();
+    return true;
+}
+
+void ConcurrentBinTree::reclaim() {
+    // Oldest epoch any reader may still be in
+    uint64_t oldest = IDLE;
+    for(const ReaderSlot& reader : readers) {
+        uint64_t epoch = reader.epoch.load();
+        if(epoch < oldest) oldest = epoch;
+    }
+    size_t freed = 0;
+    // Batches are in epoch order, a reader from epoch e started before batches retired in e were unlinked
+    while(freed < this->retired.size() && this->retired[freed].epoch < oldest) {
+        for(CNode* node : this->retired[freed].nodes) delete node;
+        ++freed;
+    }
+    this->retired.erase(this->retired.begin(), this->retired.begin() + freed);
+}
+
+/* AVL Helpers */
+
+int ConcurrentBinTree::height(const CNode* cur) {
+    return cur == nullptr ? 0 : cur->height;
+}
+
+void ConcurrentBinTree::updateHeight(CNode* cur) {
+    int left = height(cur->left);
+    int right = height(cur->right);
+    cur->height = 1 + (left > right ? left : right);
+}
+
+struct ConcurrentBinTree::Links {
+    CNode*& left(CNode* cur) const { return cur->left; }
+    CNode*& right(CNode* cur) const { return cur->right; }
+    int height(const CNode* cur) const { return ConcurrentBinTree::height(cur); }
+    void update(CNode* cur) const { ConcurrentBinTree::updateHeight(cur); }
+};
+
+void ConcurrentBinTree::rebalance(CNode*& cur) {
+    // Rotated nodes are always on the insertion path, so they are private copies
+    avl::rebalance(Links(), cur);
+}
+
+/* Auxilary Functions */
+
+std::ostream& operator<<(std::ostream& os, const ConcurrentBinTree& tree) {
+    ConcurrentBinTree::ReadGuard guard;
+    bool first = true;
+    // In-order traversal of the snapshot published when printing began
+    std::vector<const ConcurrentBinTree::CNode*> stack;
+    const ConcurrentBinTree::CNode* cur = tree.root.load();
+    while(cur != nullptr || !stack.empty()) {
+        while(cur != nullptr) {
+            stack.push_back(cur);
+            cur = cur->left;
+        }
+        cur = stack.back();
+        stack.pop_back();
+        if(!first) {
+            os << " ";
+        }
+        else {
+            first = false;
+        }
+        os << *cur->data;
+        cur = cur->right;
+    }
+    os << std::endl;
+    return os;
+}
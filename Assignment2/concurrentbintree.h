@@ -0,0 +1,136 @@
+/**
+ * @file concurrentbintree.h
+ * @author haydenlauritzen@gmail.com
+ * @brief Header file for ConcurrentBinTree
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2022
+ */
+
+#pragma once
+
+#include<atomic>
+#include<cstdint>
+#include<iostream>
+#include<mutex>
+#include<vector>
+#include"nodedata.h"
+
+/**
+ * @brief Read-mostly AVL tree whose lookups are lock-free.
+ * @details
+ * Published nodes are never modified. insert() copies the nodes on the path to the new value,
+ * rebalances the copies and publishes them with a single atomic store of the root, so readers
+ * always see a complete tree. Writers are serialized by a mutex.
+ * Replaced nodes are reclaimed with epoch-based reclamation: a reader announces the epoch it
+ * started in, and nodes retired in an epoch are freed once no reader from that epoch remains.
+ */
+class ConcurrentBinTree {
+
+    /**
+     * @brief Prints the values in sorted order, safe to call concurrently with insert().
+     * @return ostream&
+     */
+    friend std::ostream& operator<<(std::ostream&, const ConcurrentBinTree&);
+
+private:
+
+    struct CNode {
+        CNode *left, *right; // Only modified before the node is published
+        NodeData *data;
+        int height;
+    };
+
+    /**
+     * @brief Announces the calling thread as a reader for its lifetime.
+     * @details Each thread claims one of MAXREADERS slots the first time it reads.
+     */
+    class ReadGuard {
+    public:
+        ReadGuard();
+        ~ReadGuard();
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+    private:
+        std::atomic<uint64_t>* slot;
+    };
+
+    static const int MAXREADERS = 128;
+    static const uint64_t IDLE = UINT64_MAX; // Slot value of a thread that is not reading
+
+    // One slot per reader thread, padded so readers do not share cache lines
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{IDLE};
+        std::atomic<bool> claimed{false};
+    };
+    static ReaderSlot readers[MAXREADERS];
+    static std::atomic<uint64_t> globalEpoch;
+
+    struct Retired {
+        uint64_t epoch; // Epoch in which the nodes were unlinked
+        std::vector<CNode*> nodes;
+    };
+
+    std::atomic<CNode*> root;
+    std::atomic<size_t> count;
+    std::mutex writeLock;
+    std::vector<Retired> retired; // Guarded by writeLock
+
+    /**
+     * @brief Frees retired nodes that no active reader can still reach.
+     * @pre writeLock is held.
+     */
+    void reclaim();
+
+    /* AVL Helpers, only applied to nodes that are not yet published */
+
+    static int height(const CNode*);
+    static void updateHeight(CNode*);
+    static void rebalance(CNode*&);
+    struct Links; // Describes CNode links to the rotations in avl.h
+
+public:
+
+    /* Constructors */
+    /**
+     * @brief Creates an empty tree.
+     */
+    ConcurrentBinTree();
+    ConcurrentBinTree(const ConcurrentBinTree&) = delete;
+    ConcurrentBinTree& operator=(const ConcurrentBinTree&) = delete;
+    /**
+     * @brief Destroys the tree and its data.
+     * @pre No other thread is using the tree.
+     */
+    ~ConcurrentBinTree();
+
+    /* Accessors */
+
+    /**
+     * @brief Returns a pointer by reference of a specific value in the tree, lock-free.
+     * @details The pointer stays valid for the lifetime of the tree.
+     * @param value - Value to search for in tree.
+     * @param ptr - Pointer to 'value'.
+     * @return true If the value is in the tree
+     * @return false If the value is not in the tree.
+     */
+    bool retrieve(const NodeData&, NodeData*&) const;
+    /**
+     * @brief Returns the number of values in the tree.
+     */
+    size_t size() const;
+    /**
+     * @brief Determines if the tree is empty.
+     */
+    bool isEmpty() const;
+
+    /* Mutators */
+
+    /**
+     * @brief Inserts a value, serialized with other writers.
+     * @pre NodeData is dynamically allocated.
+     * @return true If the value was inserted, the tree takes ownership.
+     * @return false If the value is a duplicate, the caller keeps ownership.
+     */
+    bool insert(NodeData*);
+
+};
@@ -1 +1 @@
-g++ nodedata.cpp bintree.cpp lab2.cpp -g -std=c++17 -o Lab2.out && ./Lab2.out && rm Lab2.out
\ No newline at end of file
+g++ nodedata.cpp bintree.cpp lab2.cpp -g -std=c++17 -pthread -o Lab2.out && ./Lab2.out && rm Lab2.out
\ No newline at end of file
@@ -1,53 +1,114 @@
 #include "nodedata.h"
 
 //------------------- constructors/destructor  -------------------------------
-NodeData::NodeData() { data = ""; }                         // default
+NodeData::NodeData() { data = ""; setCache(); }            // default
 
 NodeData::~NodeData() { }            // needed so strings are deleted properly
 
-NodeData::NodeData(const NodeData& nd) { data = nd.data; }  // copy
+NodeData::NodeData(const NodeData& nd) { data = nd.data; prefix = nd.prefix; hashValue = nd.hashValue; }  // copy
 
-NodeData::NodeData(const string& s) { data = s; }    // cast string to NodeData
+NodeData::NodeData(const string& s) { data = s; setCache(); }  // cast string to NodeData
+
+NodeData::NodeData(string&& s) : data(std::move(s)) { setCache(); }  // move string in
+
+NodeData::NodeData(NodeData&& nd) noexcept : data(std::move(nd.data)), prefix(nd.prefix), hashValue(nd.hashValue) {
+	nd.setCache();
+}                                                                  // move
 
 //------------------------- operator= ----------------------------------------
 NodeData& NodeData::operator=(const NodeData& rhs) {
 	if (this != &rhs) {
 		data = rhs.data;
+		prefix = rhs.prefix;
+		hashValue = rhs.hashValue;
+	}
+	return *this;
+}
+
+NodeData& NodeData::operator=(NodeData&& rhs) noexcept {
+	if (this != &rhs) {
+		data = std::move(rhs.data);
+		prefix = rhs.prefix;
+		hashValue = rhs.hashValue;
+		rhs.setCache();
 	}
 	return *this;
 }
 
+//------------------------------- view ---------------------------------------
+string_view NodeData::view() const {
+	return data;
+}
+
+//------------------------------ compare -------------------------------------
+int NodeData::compare(string_view key) const {
+	return compare(key, prefixOf(key));
+}
+
+// prefixes resolve most comparisons, the strings are only compared on a tie
+int NodeData::compare(string_view key, uint64_t keyPrefix) const {
+	if (prefix != keyPrefix) return prefix < keyPrefix ? -1 : 1;
+	return string_view(data).compare(key);
+}
+
+//------------------------------ prefixOf ------------------------------------
+uint64_t NodeData::prefixOf(string_view key) {
+	uint64_t bytes = 0;
+	for (size_t i = 0; i < sizeof(bytes); i++) {
+		unsigned char byte = i < key.size() ? key[i] : 0;
+		bytes = bytes << 8 | byte;
+	}
+	return bytes;
+}
+
 //------------------------- operator==,!= ------------------------------------
+// prefixes resolve most comparisons, the strings are only compared on a tie
 bool NodeData::operator==(const NodeData& rhs) const {
-	return data == rhs.data;
+	return prefix == rhs.prefix && data == rhs.data;
 }
 
 bool NodeData::operator!=(const NodeData& rhs) const {
-	return data != rhs.data;
+	return prefix != rhs.prefix || data != rhs.data;
 }
 
 //------------------------ operator<,>,<=,>= ---------------------------------
 bool NodeData::operator<(const NodeData& rhs) const {
+	if (prefix != rhs.prefix) return prefix < rhs.prefix;
 	return data < rhs.data;
 }
 
 bool NodeData::operator>(const NodeData& rhs) const {
+	if (prefix != rhs.prefix) return prefix > rhs.prefix;
 	return data > rhs.data;
 }
 
 bool NodeData::operator<=(const NodeData& rhs) const {
+	if (prefix != rhs.prefix) return prefix < rhs.prefix;
 	return data <= rhs.data;
 }
 
 bool NodeData::operator>=(const NodeData& rhs) const {
+	if (prefix != rhs.prefix) return prefix > rhs.prefix;
 	return data >= rhs.data;
 }
 
+//------------------------------ setCache ------------------------------------
+void NodeData::setCache() {
+	prefix = prefixOf(data);
+	hashValue = std::hash<string>{}(data);
+}
+
+//------------------------------ hash ----------------------------------------
+size_t NodeData::hash() const {
+	return hashValue;
+}
+
 //------------------------------ setData -------------------------------------
 // returns true if the data is set, false when bad data, i.e., is eof
 
 bool NodeData::setData(istream& infile) {
 	getline(infile, data);
+	setCache();
 	return !infile.eof();       // eof function is true when eof char is read
 }
 
@@ -1,6 +1,8 @@
 	#ifndef NODEDATA_H
 #define NODEDATA_H
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <fstream>
 using namespace std;
@@ -15,13 +17,32 @@ public:
 	NodeData();          // default constructor, data is set to an empty string
 	~NodeData();
 	NodeData(const string &);      // data is set equal to parameter
+	NodeData(string &&);           // data takes over the parameter's buffer
 	NodeData(const NodeData &);    // copy constructor
+	NodeData(NodeData &&) noexcept;  // move constructor
 	NodeData& operator=(const NodeData &);
+	NodeData& operator=(NodeData &&) noexcept;
 
 	// set class data from data file
 	// returns true if the data is set, false when bad data, i.e., is eof
 	bool setData(istream&);
 
+	// hash of the string, equal NodeData have equal hashes
+	// computed once when the string is set
+	size_t hash() const;
+
+	// read-only view of the string, valid until the NodeData is changed
+	string_view view() const;
+
+	// three-way comparison with a raw key, <0, 0 or >0 like string::compare
+	int compare(string_view) const;
+
+	// same as compare(key), given prefixOf(key) so a descent computes it once
+	int compare(string_view, uint64_t) const;
+
+	// first 8 bytes of a key as they are stored in prefix
+	static uint64_t prefixOf(string_view);
+
 	bool operator==(const NodeData &) const;
 	bool operator!=(const NodeData &) const;
 	bool operator<(const NodeData &) const;
@@ -31,6 +52,11 @@ public:
 
 private:
 	string data;
+	// first 8 bytes of data, big-endian and zero padded, so comparing two
+	// prefixes as integers orders them like comparing the strings
+	uint64_t prefix;
+	size_t hashValue;  // hash of data
+	void setCache();   // recomputes prefix and hashValue from data
 };
 
 #endif
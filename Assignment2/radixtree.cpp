@@ -0,0 +1,176 @@
+/**
+ * @file radixtree.cpp
+ * @author haydenlauritzen@gmail.com
+ * @brief Implementation file for RadixTree
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2022
+ */
+
+#include"radixtree.h"
+
+/*** Constructors ***/
+
+RadixTree::RadixTree() {
+    this->root = new RNode{"", nullptr, {}};
+    this->count = 0;
+}
+
+RadixTree::~RadixTree() {
+    this->destroy(true);
+    delete this->root;
+}
+
+/* Accessors */
+
+bool RadixTree::retrieve(const NodeData& nd, NodeData*& out) const {
+    return this->retrieve(nd.view(), out);
+}
+
+bool RadixTree::retrieve(std::string_view key, NodeData*& out) const {
+    const RNode* node = this->findNode(key);
+    out = node == nullptr ? nullptr : node->data;
+    return out != nullptr;
+}
+
+const RadixTree::RNode* RadixTree::findNode(std::string_view key) const {
+    const RNode* cur = this->root;
+    while(!key.empty()) {
+        size_t i = findChild(cur, key[0]);
+        if(i == cur->children.size() || cur->children[i]->label[0] != key[0]) return nullptr;
+        cur = cur->children[i];
+        // The whole label must match, a key ending partway along an edge is not stored
+        if(key.compare(0, cur->label.size(), cur->label) != 0) return nullptr;
+        key.remove_prefix(cur->label.size());
+    }
+    return cur;
+}
+
+/* Mutators */
+
+bool RadixTree::insert(NodeData* nd) {
+    std::string_view key = nd->view();
+    RNode* cur = this->root;
+    while(!key.empty()) {
+        size_t i = findChild(cur, key[0]);
+        if(i == cur->children.size() || cur->children[i]->label[0] != key[0]) {
+            // No child shares a first character, the rest of the key becomes a leaf
+            cur->children.insert(cur->children.begin() + i, new RNode{std::string(key), nd, {}});
+            ++this->count;
+            return true;
+        }
+        RNode* child = cur->children[i];
+        size_t common = 0;
+        while(common < child->label.size() && common < key.size() && child->label[common] == key[common]) {
+            ++common;
+        }
+        if(common < child->label.size()) {
+            /*
+             * Key diverges partway along the edge, split it:
+             * cur --"label"--> child   becomes   cur --"lab"--> split --"el"--> child
+             */
+            RNode* split = new RNode{child->label.substr(0, common), nullptr, {child}};
+            child->label.erase(0, common);
+            cur->children[i] = split;
+        }
+        cur = cur->children[i];
+        key.remove_prefix(common);
+    }
+    if(cur->data != nullptr) return false;
+    cur->data = nd;
+    ++this->count;
+    return true;
+}
+
+void RadixTree::bstreeToArray(NodeData* nd[]) {
+    std::vector<NodeData*> data;
+    this->bstreeToArray(data);
+    // Array is assumed to handle ownership of values
+    for(size_t i = 0; i < data.size(); i++) {
+        nd[i] = data[i];
+    }
+}
+
+void RadixTree::bstreeToArray(std::vector<NodeData*>& nd) {
+    nd.clear();
+    nd.reserve(this->count);
+    // Pre-order, a key sorts before every key it is a prefix of
+    std::vector<const RNode*> stack{this->root};
+    while(!stack.empty()) {
+        const RNode* cur = stack.back();
+        stack.pop_back();
+        if(cur->data != nullptr) nd.push_back(cur->data);
+        for(auto child = cur->children.rbegin(); child != cur->children.rend(); ++child) {
+            stack.push_back(*child);
+        }
+    }
+    this->destroy(false); // Tree should be empty; values are owned by 'nd'
+}
+
+void RadixTree::makeEmpty() {
+    this->destroy(true);
+}
+
+void RadixTree::destroy(bool deleteData) {
+    // The root is kept, only its value and children are released
+    std::vector<RNode*> stack(this->root->children.begin(), this->root->children.end());
+    if(deleteData) delete this->root->data;
+    this->root->data = nullptr;
+    this->root->children.clear();
+    while(!stack.empty()) {
+        RNode* cur = stack.back();
+        stack.pop_back();
+        stack.insert(stack.end(), cur->children.begin(), cur->children.end());
+        if(deleteData) delete cur->data;
+        delete cur;
+    }
+    this->count = 0;
+}
+
+/* Auxilary Functions */
+
+size_t RadixTree::findChild(const RNode* cur, unsigned char c) {
+    // Binary search on the first character, compared as unsigned like NodeData
+    size_t low = 0, high = cur->children.size();
+    while(low < high) {
+        size_t mid = (low + high) / 2;
+        if(static_cast<unsigned char>(cur->children[mid]->label[0]) < c) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+bool RadixTree::isEmpty() const {
+    return this->count == 0;
+}
+
+size_t RadixTree::size() const {
+    return this->count;
+}
+
+std::ostream& operator<<(std::ostream& os, const RadixTree& rt) {
+    bool first = true;
+    // Pre-order, a key sorts before every key it is a prefix of
+    std::vector<const RadixTree::RNode*> stack{rt.root};
+    while(!stack.empty()) {
+        const RadixTree::RNode* cur = stack.back();
+        stack.pop_back();
+        if(cur->data != nullptr) {
+            if(!first) {
+                os << " ";
+            }
+            else {
+                first = false;
+            }
+            os << *cur->data;
+        }
+        for(auto child = cur->children.rbegin(); child != cur->children.rend(); ++child) {
+            stack.push_back(*child);
+        }
+    }
+    os << std::endl;
+    return os;
+}
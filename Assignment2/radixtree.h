@@ -0,0 +1,134 @@
+/**
+ * @file radixtree.h
+ * @author haydenlauritzen@gmail.com
+ * @brief Header file for RadixTree
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2022
+ */
+
+#pragma once
+
+#include<iostream>
+#include<string>
+#include<string_view>
+#include<vector>
+#include"nodedata.h"
+
+/**
+ * @brief Ordered set of NodeData with the BinTree interface, stored as a compressed trie.
+ * @details
+ * Each edge is labelled with a run of characters and chains of single-child nodes are merged,
+ * so a lookup costs O(key length) regardless of how many keys are stored, and keys that
+ * share a prefix share the nodes for it. Children are kept sorted by their first character,
+ * so a pre-order walk visits the keys in the same order as NodeData's operator<.
+ */
+class RadixTree {
+
+    /**
+     * @brief Prints the values in sorted order.
+     * @return ostream&
+     */
+    friend std::ostream& operator<<(std::ostream&, const RadixTree&);
+
+private:
+
+    struct RNode {
+        std::string label; // Characters on the edge from the parent
+        NodeData* data; // Value whose key ends here, nullptr if none
+        std::vector<RNode*> children; // Sorted by the first character of their label
+    };
+
+    RNode* root; // Has an empty label, holds the empty key
+    size_t count; // Number of keys in the tree
+
+    /**
+     * @brief Finds the child whose label starts with 'c'.
+     * @return size_t Index of the child, or where it would be inserted.
+     */
+    static size_t findChild(const RNode*, unsigned char);
+    /**
+     * @brief Finds the node whose path from the root spells 'key'.
+     * @return nullptr If no node ends exactly at 'key'.
+     */
+    const RNode* findNode(std::string_view) const;
+    /**
+     * @brief Frees every node.
+     * @param deleteData Whether the NodeData is deleted as well.
+     */
+    void destroy(bool);
+
+public:
+
+    /* Constructors */
+    /**
+     * @brief Creates an empty trie.
+     */
+    RadixTree();
+    RadixTree(const RadixTree&) = delete;
+    RadixTree& operator=(const RadixTree&) = delete;
+    /**
+     * @brief Destroys the trie and its data.
+     */
+    ~RadixTree();
+
+    /* Accessors */
+
+    /**
+     * @brief Returns a pointer by reference of a specific value in the tree.
+     * @param value - Value to search for in tree.
+     * @param ptr - Pointer to 'value'.
+     * @post If false is returned 'ptr' is a nullptr.
+     * @return true If the value is in the tree
+     * @return false If the value is not in the tree.
+     */
+    bool retrieve(const NodeData&, NodeData*&) const;
+    /**
+     * @brief Returns a pointer by reference to the value equal to a raw key.
+     * @param key - Key to search for in tree.
+     * @param ptr - Pointer to the matching value.
+     * @post If false is returned 'ptr' is a nullptr.
+     * @return true If the key is in the tree
+     * @return false If the key is not in the tree.
+     */
+    bool retrieve(std::string_view, NodeData*&) const;
+
+    /* Mutators */
+
+    /**
+     * @brief Inserts a value into the tree.
+     * @details An edge is split when the key diverges partway along its label.
+     * @pre NodeData is dynamically allocated.
+     * @return true If the value was inserted, the tree takes ownership.
+     * @return false If the value is a duplicate, the caller keeps ownership.
+     */
+    bool insert(NodeData*);
+    /**
+     * @brief Fills an array with the tree's data in sorted order and empties the tree.
+     * @param data Array of Data values from tree.
+     * @post Tree is empty.
+     */
+    void bstreeToArray(NodeData*[]);
+    /**
+     * @brief Moves the tree's data into a vector in sorted order and empties the tree.
+     * @param data Replaced with the Data values from the tree.
+     * @post Tree is empty.
+     */
+    void bstreeToArray(std::vector<NodeData*>&);
+    /**
+     * @brief Empties the tree.
+     * @post isEmpty() == true
+     */
+    void makeEmpty();
+
+    /* Auxilary Functions */
+
+    /**
+     * @brief Determines if the tree is empty.
+     */
+    bool isEmpty() const;
+    /**
+     * @brief Returns the number of values in the tree.
+     */
+    size_t size() const;
+
+};
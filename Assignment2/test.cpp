@@ -1,6 +1,12 @@
-#if 0
-
+#include"basicbintree.h"
 #include"bintree.h"
+#include"btree.h"
+#include"concurrentbintree.h"
+#include"radixtree.h"
+#include<algorithm>
+#include<atomic>
+#include<sstream>
+#include<thread>
 
 using namespace std;
 
@@ -49,6 +55,435 @@ int main() {
 	BinTree copyCE(root);
 	copyCE == root ? cerr << "Copy to Single Value Test Passed\n" : cerr << "Copy to Single Value Test Failed\n";
 	cout << "---------------------------------------------------------------\n"; 	// Test Assignemnt Bounds
+	// Test Balanced Mode with sorted input
+	BinTree plain, avl(BinTree::Balance::AVL);
+	int plainHeight = 0, avlHeight = 0;
+	for(char c = 'a'; c <= 'z'; c++) {
+		plain.insert(new NodeData(string(1, c)));
+		avl.insert(new NodeData(string(1, c)));
+	}
+	for(char c = 'a'; c <= 'z'; c++) {
+		plainHeight = max(plainHeight, plain.getHeight(NodeData(string(1, c))));
+		avlHeight = max(avlHeight, avl.getHeight(NodeData(string(1, c))));
+	}
+	plainHeight == 26 ? cerr << "Unbalanced Sorted Height Test Passed\n" : cerr << "Unbalanced Sorted Height Test Failed\n";
+	avlHeight <= 6 ? cerr << "AVL Sorted Height Test Passed\n" : cerr << "AVL Sorted Height Test Failed\n";
+	BinTree avlCopy(avl);
+	avlCopy == avl ? cerr << "AVL Copy Shape Test Passed\n" : cerr << "AVL Copy Shape Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Lookups on an Unordered Tree
+	BinTree unordered;
+	NodeData* unsorted[ARRAYSIZE] = { new NodeData("c"), new NodeData("a"), new NodeData("b") };
+	unordered.arrayToBSTree(unsorted);
+	!unordered.isOrdered() ? cerr << "Unsorted Array Order Test Passed\n" : cerr << "Unsorted Array Order Test Failed\n";
+	NodeData* found;
+	unordered.retrieve(NodeData("c"), found) && unordered.retrieve(NodeData("b"), found) ? cerr << "Unordered Retrieve Test Passed\n" : cerr << "Unordered Retrieve Test Failed\n";
+	BinTree repeated;
+	NodeData* sortedRepeats[ARRAYSIZE] = { new NodeData("a"), new NodeData("b"), new NodeData("b"), new NodeData("c") };
+	repeated.arrayToBSTree(sortedRepeats);
+	!repeated.isOrdered() && repeated.size() == 4 && repeated.retrieve(NodeData("b"), found) && repeated.retrieve(NodeData("c"), found) ? cerr << "Sorted Array with Repeats Order Test Passed\n" : cerr << "Sorted Array with Repeats Order Test Failed\n";
+	avl.isOrdered() && avl.retrieve(NodeData("q"), found) && !avl.retrieve(NodeData("qq"), found) ? cerr << "Ordered Retrieve Test Passed\n" : cerr << "Ordered Retrieve Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test In-order Iterator in both directions
+	ostringstream forward, backward;
+	for(BinTree::Iterator it = avl.begin(); it != avl.end(); ++it) {
+		forward << *it;
+	}
+	for(BinTree::Iterator it = avl.end(); it != avl.begin(); ) {
+		--it;
+		backward << *it;
+	}
+	forward.str() == "abcdefghijklmnopqrstuvwxyz" ? cerr << "Forward Iterator Test Passed\n" : cerr << "Forward Iterator Test Failed\n";
+	backward.str() == "zyxwvutsrqponmlkjihgfedcba" ? cerr << "Backward Iterator Test Passed\n" : cerr << "Backward Iterator Test Failed\n";
+	empty.begin() == empty.end() ? cerr << "Empty Iterator Test Passed\n" : cerr << "Empty Iterator Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Vector Bulk Loading
+	vector<NodeData*> bulk;
+	for(int i = 0; i < 1000; i++) {
+		bulk.push_back(new NodeData(to_string(100000 + i)));
+	}
+	NodeData* firstBulk = bulk[0];
+	BinTree loaded;
+	loaded.arrayToBSTree(bulk);
+	bulk.empty() && loaded.getHeight(NodeData("100500")) == 10 ? cerr << "Vector arrayToBSTree Test Passed\n" : cerr << "Vector arrayToBSTree Test Failed\n";
+	loaded.bstreeToArray(bulk);
+	bulk.size() == 1000 && bulk[0] == firstBulk && loaded.isEmpty() ? cerr << "Vector bstreeToArray Test Passed\n" : cerr << "Vector bstreeToArray Test Failed\n";
+	for(NodeData* nd : bulk) {
+		delete nd;
+	}
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Structural and Copy-on-Write Copies
+	BinTree unorderedCopy(unordered);
+	unorderedCopy == unordered && !unorderedCopy.isOrdered() ? cerr << "Unordered Copy Shape Test Passed\n" : cerr << "Unordered Copy Shape Test Failed\n";
+	BinTree shared = avl.share();
+	shared == avl && shared.isShared() && avl.isShared() ? cerr << "Shared Copy Test Passed\n" : cerr << "Shared Copy Test Failed\n";
+	NodeData* sharedDuplicate = new NodeData("q");
+	!shared.insert(sharedDuplicate) && !shared.remove(NodeData("qq")) && shared.isShared() ? cerr << "Unchanged Shared Copy Test Passed\n" : cerr << "Unchanged Shared Copy Test Failed\n";
+	delete sharedDuplicate;
+	BinTree sharedRemove = avl.share();
+	sharedRemove.remove(NodeData("q")) && !sharedRemove.isShared() && !sharedRemove.retrieve(NodeData("q"), found) && avl.retrieve(NodeData("q"), found) ? cerr << "Copy-on-Write Remove Test Passed\n" : cerr << "Copy-on-Write Remove Test Failed\n";
+	shared.insert(new NodeData("zz"));
+	!shared.isShared() && shared != avl && !avl.retrieve(NodeData("zz"), found) ? cerr << "Copy-on-Write Test Passed\n" : cerr << "Copy-on-Write Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Size and Equality Fast Rejects
+	avl.size() == 26 && shared.size() == 27 && empty.size() == 0 ? cerr << "Size Test Passed\n" : cerr << "Size Test Failed\n";
+	BinTree mirrorL, mirrorR;
+	mirrorL.insert(new NodeData("b"));
+	mirrorL.insert(new NodeData("a"));
+	mirrorR.insert(new NodeData("a"));
+	mirrorR.insert(new NodeData("b"));
+	mirrorL != mirrorR ? cerr << "Same Size Different Shape Test Passed\n" : cerr << "Same Size Different Shape Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Parallel Bulk Loading of unsorted data with duplicates
+	vector<NodeData*> words, sortedWords;
+	for(char c : string("thequickbrownfoxjumpsoverthelazydog")) {
+		words.push_back(new NodeData(string(1, c)));
+	}
+	for(char c = 'a'; c <= 'z'; c++) {
+		sortedWords.push_back(new NodeData(string(1, c)));
+	}
+	BinTree parallel, sequential;
+	parallel.setParallelism(4);
+	parallel.bulkLoad(words);
+	sequential.arrayToBSTree(sortedWords);
+	parallel == sequential && words.empty() ? cerr << "Parallel bulkLoad Test Passed\n" : cerr << "Parallel bulkLoad Test Failed\n";
+	BinTree parallelCopy(parallel);
+	parallelCopy == parallel && parallelCopy.getParallelism() == 4 ? cerr << "Parallel Copy Test Passed\n" : cerr << "Parallel Copy Test Failed\n";
+	// Inserted nodes come from many pool blocks, all of them are cleared in one parallel pass
+	BinTree blocks(BinTree::Balance::AVL);
+	blocks.setParallelism(4);
+	for(int i = 0; i < 20000; i++) {
+		blocks.insert(new NodeData(to_string(100000 + i)));
+	}
+	blocks.makeEmpty();
+	blocks.isEmpty() && blocks.size() == 0 && blocks.insert(new NodeData("a")) && blocks.size() == 1 ? cerr << "Parallel makeEmpty Test Passed\n" : cerr << "Parallel makeEmpty Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Order Statistics and Range Queries
+	avl.rank(NodeData("a")) == 0 && avl.rank(NodeData("m")) == 12 && avl.rank(NodeData("mm")) == 13 ? cerr << "Rank Test Passed\n" : cerr << "Rank Test Failed\n";
+	*avl.select(0) == NodeData("a") && *avl.select(25) == NodeData("z") && avl.select(26) == nullptr ? cerr << "Select Test Passed\n" : cerr << "Select Test Failed\n";
+	avl.countRange(NodeData("c"), NodeData("f")) == 4 && avl.countRange(NodeData("cc"), NodeData("ff")) == 3 ? cerr << "Count Range Test Passed\n" : cerr << "Count Range Test Failed\n";
+	ostringstream inRange;
+	for(const NodeData& nd : avl.range(NodeData("w"), NodeData("zz"))) {
+		inRange << nd;
+	}
+	inRange.str() == "wxyz" && avl.size() == 26 ? cerr << "Range Iterator Test Passed\n" : cerr << "Range Iterator Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Cached Heights
+	vector<pair<const NodeData*, int>> heights;
+	plain.getHeights(heights);
+	bool heightsMatch = heights.size() == 26;
+	for(size_t i = 0; i < heights.size(); i++) {
+		// Sorted input makes a right-leaning chain, 'a' is the root
+		heightsMatch = heightsMatch && heights[i].second == int(26 - i) && heights[i].second == plain.getHeight(*heights[i].first);
+	}
+	heightsMatch ? cerr << "All Heights Test Passed\n" : cerr << "All Heights Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Remove
+	NodeData* removed;
+	vector<NodeData> vowels = { NodeData("a"), NodeData("e"), NodeData("i"), NodeData("o"), NodeData("u"), NodeData("aa") };
+	avl.remove(vowels) == 5 && avl.size() == 21 && !avl.retrieve(NodeData("e"), removed) && avl.retrieve(NodeData("f"), removed) ? cerr << "Batch Remove Test Passed\n" : cerr << "Batch Remove Test Failed\n";
+	plain.remove(NodeData("a")) && !plain.remove(NodeData("a")) && *plain.begin() == NodeData("b") ? cerr << "Remove Root Test Passed\n" : cerr << "Remove Root Test Failed\n";
+	for(char c = 'a'; c <= 'z'; c++) {
+		avl.remove(NodeData(string(1, c)));
+	}
+	avl.isEmpty() && avl.getHeight(NodeData("m")) == 0 ? cerr << "Remove All Test Passed\n" : cerr << "Remove All Test Failed\n";
+	for(char c = 'a'; c <= 'z'; c++) {
+		avl.insert(new NodeData(string(1, c)));
+	}
+	avl.size() == 26 && avl.rank(NodeData("m")) == 12 ? cerr << "Reinsert Test Passed\n" : cerr << "Reinsert Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Raw Key Lookup and Emplace
+	NodeData* viewed;
+	string moved = "zz";
+	avl.retrieve(string_view("q"), viewed) && *viewed == NodeData("q") && !avl.retrieve("qq", viewed) && viewed == nullptr ? cerr << "String View Retrieve Test Passed\n" : cerr << "String View Retrieve Test Failed\n";
+	avl.emplace(std::move(moved)) && !avl.emplace(string("q")) && avl.retrieve(string("zz"), viewed) && avl.size() == 27 ? cerr << "Emplace Test Passed\n" : cerr << "Emplace Test Failed\n";
+	NodeData source("moved");
+	NodeData target(std::move(source));
+	source = std::move(target);
+	source == NodeData("moved") ? cerr << "NodeData Move Test Passed\n" : cerr << "NodeData Move Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Key Prefixes
+	NodeData longA("abcdefghij"), longB("abcdefghik"), shortA("abc"), nul(string("abc\0", 4));
+	longA < longB && !(longB < longA) && shortA < longA && shortA < nul && shortA != nul && NodeData("\xff") > NodeData("a") ? cerr << "Prefix Compare Test Passed\n" : cerr << "Prefix Compare Test Failed\n";
+	longA.compare("abcdefghik") < 0 && longA.compare("abc") > 0 && shortA.compare(string_view("abc\0", 4)) < 0 && NodeData("\xff").compare("a") > 0 && longB.compare("abcdefghik") == 0 ? cerr << "Prefix Raw Key Compare Test Passed\n" : cerr << "Prefix Raw Key Compare Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Streaming Loader
+	istringstream sections("iii not tttt eee r not and jj r eee\n pp r sssss eee $$\nb a c b a c $$\n\n$$ c b a");
+	vector<BinTree> sectionTrees;
+	BinTree byHand;
+	for(string token : { "iii", "not", "tttt", "eee", "r", "and", "jj", "pp", "sssss" }) {
+		byHand.insert(new NodeData(token));
+	}
+	BinTree::loadAll(sections, sectionTrees) == 4 && sectionTrees[0] == byHand && sectionTrees[1].size() == 3 && sectionTrees[2].isEmpty() && sectionTrees[3].size() == 3 ? cerr << "Load All Test Passed\n" : cerr << "Load All Test Failed\n";
+	istringstream small("abcdefghij klmnopqrstuvwxyz $$ zz");
+	BinTree::Loader loader(small, 4);
+	BinTree longWords, rest, none;
+	loader.next(longWords) && loader.next(rest) && !loader.next(none) && longWords.retrieve("klmnopqrstuvwxyz", viewed) && rest.size() == 1 ? cerr << "Loader Block Boundary Test Passed\n" : cerr << "Loader Block Boundary Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Buffered Rendering
+	BinTree small3;
+	for(string token : { "b", "a", "c", "d" }) {
+		small3.insert(new NodeData(token));
+	}
+	ostringstream sideways, limited, inOrder;
+	small3.displaySideways(sideways);
+	small3.displaySideways(limited, 1);
+	inOrder << small3;
+	sideways.str() == "                d\n            c\n        b\n            a\n" ? cerr << "Sideways Stream Test Passed\n" : cerr << "Sideways Stream Test Failed\n";
+	limited.str() == "            ... (2)\n        b\n            ... (1)\n" && inOrder.str() == "a b c d\n" ? cerr << "Sideways Depth Limit Test Passed\n" : cerr << "Sideways Depth Limit Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Snapshots
+	BinTree restored, restoredEmpty;
+	bool saved = avl.save("snapshot.bin") && restoredEmpty.save("empty.bin");
+	{
+		BinTree::Snapshot snapshot("snapshot.bin");
+		snapshot.isOpen() && snapshot.size() == 27 && snapshot[0] == "a" && snapshot.contains("zz") && !snapshot.contains("zzz") ? cerr << "Snapshot Query Test Passed\n" : cerr << "Snapshot Query Test Failed\n";
+	}
+	saved && restored.load("snapshot.bin") && restored == avl && restored.getHeight(NodeData("q")) == avl.getHeight(NodeData("q")) ? cerr << "Snapshot Load Test Passed\n" : cerr << "Snapshot Load Test Failed\n";
+	restored.load("empty.bin") && restored.isEmpty() && !restored.load("testData.txt") ? cerr << "Snapshot Empty Test Passed\n" : cerr << "Snapshot Empty Test Failed\n";
+	remove("snapshot.bin");
+	remove("empty.bin");
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Inline Keys
+	BasicBinTree<int> integers;
+	for(int i = 1; i <= 1000; i++) {
+		integers.insert(i);
+	}
+	vector<int> sortedIntegers;
+	integers.toVector(sortedIntegers);
+	!integers.insert(500) && integers.contains(1000) && !integers.contains(0) && integers.size() == 1000 && sortedIntegers.front() == 1 && sortedIntegers.back() == 1000 && integers.getHeight() <= 14 ? cerr << "Inline Key Test Passed\n" : cerr << "Inline Key Test Failed\n";
+	BasicBinTree<int, greater<int>> descending;
+	descending.insert(1);
+	descending.insert(3);
+	descending.insert(2);
+	ostringstream descendingOut;
+	descendingOut << descending;
+	descendingOut.str() == "3 2 1\n" ? cerr << "Custom Compare Test Passed\n" : cerr << "Custom Compare Test Failed\n";
+	// Both trees share the rotations in avl.h, so the same inserts give the same shape
+	BasicBinTree<NodeData> inlineKeys;
+	BinTree pointerKeys(BinTree::Balance::AVL);
+	for(int i = 0; i < 2000; i++) {
+		string key = to_string((i * 7919) % 1500); // the last 500 inserts repeat earlier keys
+		NodeData* nd = new NodeData(key);
+		if(inlineKeys.insert(NodeData(key)) != pointerKeys.insert(nd)) cerr << "Inline Key Insert Parity Test Failed\n";
+		if(!pointerKeys.retrieve(NodeData(key), found) || found != nd) delete nd;
+	}
+	bool lookupParity = inlineKeys.size() == pointerKeys.size();
+	for(int i = 0; i < 1600; i++) {
+		NodeData probe(to_string(i));
+		const NodeData* inlineFound = inlineKeys.find(probe);
+		bool pointerFound = pointerKeys.retrieve(probe, found);
+		lookupParity = lookupParity && pointerFound == (inlineFound != nullptr) && (!pointerFound || *found == *inlineFound);
+	}
+	vector<pair<const NodeData*, int>> pointerHeights;
+	pointerKeys.getHeights(pointerHeights);
+	int pointerHeight = 0;
+	for(const auto& height : pointerHeights) {
+		pointerHeight = max(pointerHeight, height.second);
+	}
+	lookupParity && inlineKeys.getHeight() == pointerHeight ? cerr << "Inline Key Retrieve Parity Test Passed\n" : cerr << "Inline Key Retrieve Parity Test Failed\n";
+	vector<NodeData> inlineSorted;
+	inlineKeys.toVector(inlineSorted);
+	vector<NodeData*> pointerSorted;
+	pointerKeys.bstreeToArray(pointerSorted);
+	bool orderParity = inlineSorted.size() == pointerSorted.size() && pointerKeys.isEmpty();
+	for(size_t i = 0; i < pointerSorted.size(); i++) {
+		orderParity = orderParity && inlineSorted[i] == *pointerSorted[i];
+		delete pointerSorted[i];
+	}
+	orderParity ? cerr << "Inline Key bstreeToArray Parity Test Passed\n" : cerr << "Inline Key bstreeToArray Parity Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Stats
+	BinTree::Stats stats = small3.getStats();
+	ostringstream statsJson;
+	stats.writeJson(statsJson);
+	stats.size == 4 && stats.height == 3 && stats.optimalHeight == 3 && stats.depths == vector<size_t>{ 1, 2, 1 } && stats.payloads == 4 && stats.nodeBytes > 0 ? cerr << "Stats Shape Test Passed\n" : cerr << "Stats Shape Test Failed\n";
+	statsJson.str().find("\"depths\":[1,2,1]}") != string::npos && BinTree().getStats().height == 0 ? cerr << "Stats JSON Test Passed\n" : cerr << "Stats JSON Test Failed\n";
+	// A copy-on-write insert counts the comparisons of one descent, when built with -DBINTREE_STATS
+	BinTree statsSource;
+	for(string s : { "d", "b", "f", "a", "c", "e", "g" }) statsSource.insert(new NodeData(s));
+	BinTree statsShared = statsSource.share();
+	uint64_t comparisons = statsShared.getStats().insertComparisons;
+	statsShared.insert(new NodeData("h"));
+	BinTree::Stats sharedStats = statsShared.getStats();
+	!statsShared.isShared() && (!sharedStats.counted || sharedStats.insertComparisons - comparisons == 3) ? cerr << "Copy-on-Write Stats Test Passed\n" : cerr << "Copy-on-Write Stats Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Set Algebra
+	BinTree evens, thirds;
+	for(char c = 'a'; c <= 'z'; c += 2) {
+		evens.insert(new NodeData(string(1, c)));
+	}
+	for(char c = 'a'; c <= 'z'; c += 3) {
+		thirds.insert(new NodeData(string(1, c)));
+	}
+	ostringstream both, eitherOut, onlyEvens;
+	both << evens.intersection(thirds);
+	BinTree either = evens.setUnion(thirds);
+	eitherOut << either;
+	onlyEvens << evens.difference(thirds);
+	both.str() == "a g m s y\n" && either.size() == 17 && either.getHeight(*either.select(0)) <= 3 && onlyEvens.str() == "c e i k o q u w\n" ? cerr << "Set Algebra Test Passed\n" : cerr << "Set Algebra Test Failed\n";
+	evens.isSubset(either) && !either.isSubset(evens) && empty.isSubset(evens) && evens.intersection(empty).isEmpty() ? cerr << "Subset Test Passed\n" : cerr << "Subset Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Counting Duplicates
+	BinTree frequency;
+	frequency.setCounting(true);
+	for(string token : { "not", "and", "not", "r", "eee", "r", "not", "eee" }) {
+		frequency.insert(new NodeData(token));
+	}
+	frequency.emplace("and");
+	vector<pair<const NodeData*, size_t>> frequent;
+	frequency.topK(2, frequent);
+	ostringstream counted;
+	frequency.displayCounts(counted);
+	frequency.size() == 4 && frequency.count(NodeData("not")) == 3 && frequency.count(NodeData("zzz")) == 0 && frequency.isCounting() ? cerr << "Count Test Passed\n" : cerr << "Count Test Failed\n";
+	frequent.size() == 2 && *frequent[0].first == NodeData("not") && frequent[0].second == 3 && *frequent[1].first == NodeData("and") ? cerr << "Top K Test Passed\n" : cerr << "Top K Test Failed\n";
+	frequency.remove(NodeData("not"));
+	counted.str() == "and:2 eee:2 not:3 r:2\n" && frequency.count(NodeData("not")) == 2 && BinTree(frequency) == frequency ? cerr << "Display Counts Test Passed\n" : cerr << "Display Counts Test Failed\n";
+	// Trees past the parallel cutoff are copied on several threads, counts included
+	BinTree largeCounts(BinTree::Balance::AVL);
+	largeCounts.setCounting(true);
+	largeCounts.setParallelism(4);
+	for(int i = 0; i < 20000; i++) {
+		largeCounts.insert(new NodeData(to_string(100000 + i)));
+		if(i % 3 == 0) largeCounts.insert(new NodeData(to_string(100000 + i)));
+	}
+	BinTree largeCopy(largeCounts);
+	BinTree largeAssigned;
+	largeAssigned = largeCounts;
+	largeCopy == largeCounts && largeAssigned == largeCounts && largeCopy.count(NodeData("100000")) == 2 && largeAssigned.count(NodeData("119999")) == 1 ? cerr << "Parallel Copy Counts Test Passed\n" : cerr << "Parallel Copy Counts Test Failed\n";
+	BinTree countedArray, countedBulk;
+	countedArray.setCounting(true);
+	countedBulk.setCounting(true);
+	NodeData* sortedCounts[ARRAYSIZE] = { new NodeData("a"), new NodeData("a"), new NodeData("a"), new NodeData("b") };
+	countedArray.arrayToBSTree(sortedCounts);
+	vector<NodeData*> unsortedCounts = { new NodeData("b"), new NodeData("a"), new NodeData("a"), new NodeData("a") };
+	countedBulk.bulkLoad(unsortedCounts);
+	ostringstream arrayCounts;
+	countedArray.displayCounts(arrayCounts);
+	arrayCounts.str() == "a:3 b:1\n" && countedArray.size() == 2 && countedArray.isOrdered() && countedBulk.count(NodeData("a")) == 3 && countedBulk == countedArray ? cerr << "Bulk Load Counts Test Passed\n" : cerr << "Bulk Load Counts Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test B-tree Splits, Lookups and Sorted Output
+	BTree btree;
+	vector<string> bkeys;
+	for(int i = 0; i < 1000; i++) {
+		bkeys.push_back(to_string(100000 + (i * 7919) % 1000)); // 7919 is coprime to 1000, so every key appears once, shuffled
+	}
+	bool bInserted = true;
+	for(const string& key : bkeys) {
+		bInserted = btree.insert(new NodeData(key)) && bInserted;
+	}
+	NodeData* bDuplicate = new NodeData("100500");
+	bInserted && !btree.insert(bDuplicate) && btree.size() == 1000 && btree.getHeight() > 1 ? cerr << "B-tree Split Insert Test Passed\n" : cerr << "B-tree Split Insert Test Failed\n";
+	delete bDuplicate;
+	bool bFound = true;
+	for(const string& key : bkeys) {
+		bFound = btree.retrieve(NodeData(key), found) && *found == NodeData(key) && bFound;
+	}
+	bFound && !btree.retrieve(NodeData("100999x"), found) && !btree.retrieve(NodeData("0"), found) ? cerr << "B-tree Retrieve Test Passed\n" : cerr << "B-tree Retrieve Test Failed\n";
+	sort(bkeys.begin(), bkeys.end());
+	ostringstream bOutput, bExpected;
+	bOutput << btree;
+	for(size_t i = 0; i < bkeys.size(); i++) {
+		bExpected << (i == 0 ? "" : " ") << bkeys[i];
+	}
+	bExpected << endl;
+	bOutput.str() == bExpected.str() ? cerr << "B-tree In-order Output Test Passed\n" : cerr << "B-tree In-order Output Test Failed\n";
+	vector<NodeData*> bArray;
+	btree.bstreeToArray(bArray);
+	bool bSorted = bArray.size() == bkeys.size();
+	for(size_t i = 0; bSorted && i < bArray.size(); i++) {
+		bSorted = *bArray[i] == NodeData(bkeys[i]);
+	}
+	bSorted && btree.isEmpty() ? cerr << "B-tree Vector bstreeToArray Test Passed\n" : cerr << "B-tree Vector bstreeToArray Test Failed\n";
+	for(NodeData* nd : bArray) {
+		delete nd;
+	}
+	// 100 keys still split the root, and fill the array exactly
+	for(int i = 99; i >= 0; i--) {
+		btree.insert(new NodeData(to_string(100 + i)));
+	}
+	NodeData* bFixed[ARRAYSIZE];
+	initArray(bFixed);
+	btree.bstreeToArray(bFixed);
+	bSorted = btree.isEmpty();
+	for(int i = 0; i < ARRAYSIZE; i++) {
+		bSorted = bSorted && bFixed[i] != nullptr && *bFixed[i] == NodeData(to_string(100 + i));
+		delete bFixed[i];
+	}
+	bSorted ? cerr << "B-tree Array bstreeToArray Test Passed\n" : cerr << "B-tree Array bstreeToArray Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Radix Tree Edge Splits, Prefix Keys and the Empty Key
+	RadixTree radix;
+	radix.insert(new NodeData("romane"));
+	radix.insert(new NodeData("romanus")); // splits "romane" after "roman"
+	radix.insert(new NodeData("romulus")); // splits "roman" after "rom"
+	radix.retrieve(NodeData("romane"), found) && radix.retrieve(NodeData("romanus"), found) && radix.retrieve(NodeData("romulus"), found)
+		&& !radix.retrieve(NodeData("roman"), found) && !radix.retrieve(NodeData("rom"), found) && found == nullptr ? cerr << "Radix Shared Prefix Split Test Passed\n" : cerr << "Radix Shared Prefix Split Test Failed\n";
+	radix.insert(new NodeData("rom")); // ends at an existing branch
+	radix.insert(new NodeData("romanes")); // extends an existing key
+	radix.retrieve(NodeData("rom"), found) && *found == NodeData("rom") && radix.retrieve(string_view("romanes"), found) && radix.retrieve(NodeData("romane"), found)
+		&& !radix.retrieve(NodeData("ro"), found) && !radix.retrieve(NodeData("romanesque"), found) && radix.size() == 5 ? cerr << "Radix Prefix Key Test Passed\n" : cerr << "Radix Prefix Key Test Failed\n";
+	!radix.retrieve(NodeData(""), found) && radix.insert(new NodeData("")) && radix.retrieve(string_view(""), found) && *found == NodeData("") ? cerr << "Radix Empty Key Test Passed\n" : cerr << "Radix Empty Key Test Failed\n";
+	NodeData* radixDuplicate = new NodeData("romanus");
+	NodeData* emptyDuplicate = new NodeData("");
+	!radix.insert(radixDuplicate) && !radix.insert(emptyDuplicate) && radix.size() == 6 ? cerr << "Radix Duplicate Test Passed\n" : cerr << "Radix Duplicate Test Failed\n";
+	delete radixDuplicate;
+	delete emptyDuplicate;
+	vector<NodeData*> radixArray;
+	radix.bstreeToArray(radixArray);
+	ostringstream radixOrder;
+	for(NodeData* nd : radixArray) {
+		radixOrder << "[" << *nd << "]";
+		delete nd;
+	}
+	radixOrder.str() == "[][rom][romane][romanes][romanus][romulus]" && radix.isEmpty() ? cerr << "Radix Sorted bstreeToArray Test Passed\n" : cerr << "Radix Sorted bstreeToArray Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
+	// Test Lock-free Tree Duplicates and Readers Racing a Writer
+	ConcurrentBinTree concurrent;
+	for(string key : { "m", "f", "t", "a", "h" }) {
+		concurrent.insert(new NodeData(key));
+	}
+	NodeData* concurrentDuplicate = new NodeData("h"); // deepest key, every node on its path is copied
+	!concurrent.insert(concurrentDuplicate) && concurrent.size() == 5 && concurrent.retrieve(NodeData("h"), found) && found != concurrentDuplicate ? cerr << "Concurrent Duplicate Insert Test Passed\n" : cerr << "Concurrent Duplicate Insert Test Failed\n";
+	delete concurrentDuplicate;
+	ConcurrentBinTree raced;
+	const int RACEKEYS = 20000;
+	atomic<int> published{0}; // Keys [0, published) have been inserted
+	atomic<bool> racing{true};
+	atomic<int> raceErrors{0};
+	vector<thread> readers;
+	for(int r = 0; r < 4; r++) {
+		readers.emplace_back([&, r] {
+			unsigned probe = r;
+			while(racing.load()) {
+				int limit = published.load();
+				if(limit == 0) continue;
+				probe = probe * 1103515245 + 12345;
+				string key = to_string(100000 + probe % limit);
+				NodeData* out;
+				// A published key must stay visible, and a lookup never sees a torn value
+				if(!raced.retrieve(NodeData(key), out) || *out != NodeData(key)) ++raceErrors;
+				if(raced.retrieve(NodeData("x"), out)) ++raceErrors;
+			}
+		});
+	}
+	int raceDuplicates = 0;
+	for(int i = 0; i < RACEKEYS; i++) {
+		raced.insert(new NodeData(to_string(100000 + i)));
+		published.store(i + 1);
+		// Duplicates discard their private copies while readers walk the published nodes
+		NodeData* again = new NodeData(to_string(100000 + i / 2));
+		if(!raced.insert(again)) ++raceDuplicates;
+		delete again;
+	}
+	racing.store(false);
+	for(thread& reader : readers) {
+		reader.join();
+	}
+	ostringstream racedOutput;
+	racedOutput << raced;
+	raceErrors.load() == 0 && raceDuplicates == RACEKEYS && raced.size() == RACEKEYS && racedOutput.str().compare(0, 13, "100000 100001") == 0 ? cerr << "Concurrent Readers Stress Test Passed\n" : cerr << "Concurrent Readers Stress Test Failed\n";
+	cout << "---------------------------------------------------------------\n"; 
 	ifstream infile("testData.txt");
 	if (!infile) {
 		cout << "File could not be opened." << endl;
@@ -134,5 +569,3 @@ void initArray(NodeData* ndArray[]) {
 	for (int i = 0; i < ARRAYSIZE; i++)
 		ndArray[i] = NULL;
 }
-
-#endif
@@ -1 +1 @@
-g++ nodedata.cpp bintree.cpp test.cpp -g -std=c++17 -o Test.out && ./Test.out && rm Test.out
\ No newline at end of file
+g++ nodedata.cpp bintree.cpp btree.cpp concurrentbintree.cpp radixtree.cpp test.cpp -g -std=c++17 -pthread -o Test.out && ./Test.out && rm Test.out
\ No newline at end of file
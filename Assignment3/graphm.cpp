@@ -12,21 +12,15 @@
 #include"graphm.h"
 #include<cstring> // string parsing
 #include<algorithm> // string parsing
+#include<functional> // heap ordering
+#include<queue> // heap search
 #include<stack> // output formatting
 
-GraphM::GraphM() : data{}, size(0), travel{} {
-    for(int i = 0; i < MAXNODES; ++i) {
-        for(int j = 0; j < MAXNODES; ++j) {
-            // Initalization to INT32_MAX
-            cost[i][j] = NOPATH;   
-            travel[i][j].dist = NOPATH;
-        }
-    }
-}
+GraphM::GraphM() : size(0), dense(false), single(-1) {}
 
 GraphM::~GraphM() {
     for(int i = 0; i < this->size; ++i) {
-        delete data[i];
+        delete this->data[i];
     }
 }
 
@@ -41,6 +35,7 @@ void GraphM::buildGraph(std::ifstream& file) {
     } while(line == "");
     // First line will be number of number of nodes
     this->size = std::stoi(line);
+    this->data.resize(this->size);
     // Next this->size lines will be NodeData
     for(int i = 0; i < this->size; ++i) {
         std::getline(file, line);
@@ -50,6 +45,7 @@ void GraphM::buildGraph(std::ifstream& file) {
         this->data[i] = newData; 
     }
     // Rest of text will include branches
+    std::vector<Edge> edges;
     while(!file.eof()) {
         const int NODESIZE = 3; 
         int node[NODESIZE]{};
@@ -64,45 +60,258 @@ void GraphM::buildGraph(std::ifstream& file) {
         --node[1];
         // 0 0 0 will terminate, equivalent to -1 -1 0 after zero-indexing
         if(node[0] == -1 && node[1] == -1 && node[2] == 0) break;
-        insertEdge(node[0], node[1], node[2]);
+        edges.push_back({node[0], node[1], node[2]});
+    }
+    this->pack(edges);
+}
+
+void GraphM::pack(std::vector<Edge>& edges) {
+    // Group edges by source, stable so the last of several edges between two nodes is kept
+    std::stable_sort(edges.begin(), edges.end(), [](const Edge& lhs, const Edge& rhs) {
+        return lhs.from != rhs.from ? lhs.from < rhs.from : lhs.to < rhs.to;
+    });
+    size_t kept = 0;
+    for(size_t i = 0; i < edges.size(); ++i) {
+        if(i + 1 < edges.size() && edges[i].from == edges[i+1].from && edges[i].to == edges[i+1].to) continue;
+        if(edges[i].weight == NOPATH) continue;
+        edges[kept++] = edges[i];
+    }
+    edges.resize(kept);
+    this->pending.clear();
+    // The matrix takes size*size ints, the sparse rows two ints per edge and one per node
+    long long cells = static_cast<long long>(this->size) * this->size;
+    this->dense = cells <= 2 * static_cast<long long>(edges.size()) + this->size;
+    if(this->dense) {
+        std::vector<int>().swap(this->offsets);
+        std::vector<int>().swap(this->targets);
+        std::vector<int>().swap(this->weights);
+        this->cost.assign(cells, NOPATH);
+        for(const Edge& edge : edges) {
+            this->cost[static_cast<size_t>(edge.from) * this->size + edge.to] = edge.weight;
+        }
+        return;
+    }
+    std::vector<int>().swap(this->cost);
+    this->offsets.assign(this->size + 1, 0);
+    this->targets.resize(edges.size());
+    this->weights.resize(edges.size());
+    for(size_t i = 0; i < edges.size(); ++i) {
+        ++this->offsets[edges[i].from + 1];
+        this->targets[i] = edges[i].to;
+        this->weights[i] = edges[i].weight;
+    }
+    for(int i = 0; i < this->size; ++i) {
+        this->offsets[i+1] += this->offsets[i];
+    }
+}
+
+void GraphM::flush() {
+    if(this->dense || this->pending.empty()) return;
+    std::vector<Edge> edges;
+    edges.reserve(this->targets.size() + this->pending.size());
+    for(int from = 0; from < this->size; ++from) {
+        for(int i = this->offsets[from]; i < this->offsets[from+1]; ++i) {
+            edges.push_back({from, this->targets[i], this->weights[i]});
+        }
     }
+    edges.insert(edges.end(), this->pending.begin(), this->pending.end());
+    this->pack(edges);
 }
 
 void GraphM::insertEdge(int from, int to, int weight) {
-    this->cost[from][to] = weight;
+    if(this->dense) {
+        this->cost[static_cast<size_t>(from) * this->size + to] = weight;
+        return;
+    }
+    // An edge already in the sparse rows is updated in place
+    if(!this->offsets.empty()) {
+        for(int i = this->offsets[from]; i < this->offsets[from+1]; ++i) {
+            if(this->targets[i] == to) {
+                this->weights[i] = weight;
+                return;
+            }
+        }
+    }
+    this->pending.push_back({from, to, weight});
 }
 
 void GraphM::removeEdge(int from, int to) {
-    this->cost[from][to] = NOPATH;
+    if(this->dense) {
+        this->cost[static_cast<size_t>(from) * this->size + to] = NOPATH;
+        return;
+    }
+    if(!this->offsets.empty()) {
+        for(int i = this->offsets[from]; i < this->offsets[from+1]; ++i) {
+            if(this->targets[i] == to) this->weights[i] = NOPATH;
+        }
+    }
+    this->pending.erase(std::remove_if(this->pending.begin(), this->pending.end(), [from, to](const Edge& edge) {
+        return edge.from == from && edge.to == to;
+    }), this->pending.end());
+}
+
+const GraphM::TableType& GraphM::trip(int source, int to) const {
+    static const TableType UNREACHED{false, NOPATH, 0};
+    if(this->travel.empty()) return UNREACHED;
+    if(this->single != -1) return source == this->single ? this->travel[to] : UNREACHED;
+    return this->travel[static_cast<size_t>(source) * this->size + to];
 }
 
-void GraphM::findShortestPath() {
+template<class F>
+void GraphM::forEachEdge(int from, F&& f) const {
+    if(this->dense) {
+        const int* edges = &this->cost[static_cast<size_t>(from) * this->size];
+        for(int to = 0; to < this->size; ++to) {
+            if(edges[to] != NOPATH) f(to, edges[to]);
+        }
+    }
+    else {
+        for(int j = this->offsets[from]; j < this->offsets[from+1]; ++j) {
+            if(this->weights[j] != NOPATH) f(this->targets[j], this->weights[j]);
+        }
+    }
+}
+
+bool GraphM::relax(TableType* row, int from, int to, int weight) const {
+    if(from == to) return false; // unnessary to process cost to self
+    if(row[to].visited) return false;
+    int newCost = row[from].dist + weight;
+    // if cheaper path, update cost
+    if(newCost < row[to].dist) {
+        row[to].dist = newCost;
+        row[to].path = from;
+        return true;
+    }
+    return false;
+}
+
+void GraphM::findShortestPath(Search search) {
+    this->flush();
+    int maxWeight = 0;
+    search = this->resolve(search, maxWeight);
+    this->travel.assign(static_cast<size_t>(this->size) * this->size, TableType{false, NOPATH, 0});
+    this->single = -1;
     for(int source = 0; source < this->size; ++source) {
-        this->travel[source][source].dist = 0;
-        // begin search for start -> all other nodes
-        for(int i = 0; i < this->size; ++i) { // node being processed
-            int from;
-            int cheapest = NOPATH;
-            // pick cheapest node next
-            for(int j = 0; j < this->size; ++j) {
-                if(!this->travel[source][j].visited && this->travel[source][j].dist < cheapest) {
-                    cheapest = this->travel[source][j].dist;
-                    from = j;
-                } 
-            }
-            this->travel[source][from].visited = true;
-            for(int to = 0; to < this->size; ++to) { // path from processed node
-                if(from == to) continue; // unnessary to process cost to self
-                if(this->cost[from][to] != NOPATH && this->travel[source][to].visited == false) {
-                    int newCost = this->travel[source][from].dist + this->cost[from][to];
-                    int currentCost = this->travel[source][to].dist;
-                    // if cheaper path, update cost
-                    if(newCost < currentCost) {
-                        this->travel[source][to].dist = newCost;
-                        this->travel[source][to].path = from;
-                    }
-                }
-            }
+        this->solve(&this->travel[static_cast<size_t>(source) * this->size], source, search, maxWeight);
+    }
+}
+
+void GraphM::findShortestPath(int from, Search search) {
+    this->travel.clear();
+    this->single = -1;
+    if(from < 1 || from > this->size) return;
+    this->flush();
+    int maxWeight = 0;
+    search = this->resolve(search, maxWeight);
+    this->travel.assign(this->size, TableType{false, NOPATH, 0});
+    this->single = from - 1;
+    this->solve(this->travel.data(), from - 1, search, maxWeight);
+}
+
+GraphM::Search GraphM::resolve(Search search, int& maxWeight) const {
+    int minWeight = 0;
+    maxWeight = 0;
+    for(int from = 0; from < this->size; ++from) {
+        this->forEachEdge(from, [&minWeight, &maxWeight](int, int weight) {
+            if(weight < minWeight) minWeight = weight;
+            if(weight > maxWeight) maxWeight = weight;
+        });
+    }
+    if(search == Search::Auto) {
+        if(this->dense) {
+            search = Search::Scan;
+        }
+        else if(minWeight >= 0 && maxWeight <= BUCKETLIMIT) {
+            search = Search::Bucket;
+        }
+        else {
+            search = Search::Heap;
+        }
+    }
+    // Buckets are indexed by distance, so they cannot hold negative weights
+    // and large weights would need a bucket for every distance up to them
+    if(search == Search::Bucket && (minWeight < 0 || maxWeight > BUCKETLIMIT)) search = Search::Heap;
+    return search;
+}
+
+void GraphM::solve(TableType* row, int source, Search search, int maxWeight) const {
+    switch(search) {
+        case Search::Bucket:
+            this->bucketSearch(row, source, maxWeight);
+            break;
+        case Search::Heap:
+            this->heapSearch(row, source);
+            break;
+        default:
+            this->scanSearch(row, source);
+            break;
+    }
+}
+
+void GraphM::scanSearch(TableType* row, int source) const {
+    row[source].dist = 0;
+    // begin search for start -> all other nodes
+    for(int i = 0; i < this->size; ++i) { // node being processed
+        int from = -1;
+        int cheapest = NOPATH;
+        // pick cheapest node next
+        for(int j = 0; j < this->size; ++j) {
+            if(!row[j].visited && row[j].dist < cheapest) {
+                cheapest = row[j].dist;
+                from = j;
+            } 
+        }
+        // remaining nodes are unreachable from source
+        if(from == -1) break;
+        row[from].visited = true;
+        this->forEachEdge(from, [this, row, from](int to, int weight) {
+            this->relax(row, from, to, weight);
+        });
+    }
+}
+
+void GraphM::heapSearch(TableType* row, int source) const {
+    row[source].dist = 0;
+    // Ordered by distance then node, the order the scan visits them in
+    using Entry = std::pair<int, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    queue.push({0, source});
+    while(!queue.empty()) {
+        int from = queue.top().second;
+        queue.pop();
+        // A node is queued again each time its distance drops, later entries are stale
+        if(row[from].visited) continue;
+        row[from].visited = true;
+        this->forEachEdge(from, [this, row, from, &queue](int to, int weight) {
+            if(this->relax(row, from, to, weight)) queue.push({row[to].dist, to});
+        });
+    }
+}
+
+void GraphM::bucketSearch(TableType* row, int source, int maxWeight) const {
+    row[source].dist = 0;
+    // Queued distances lie within maxWeight of the current one, so maxWeight+1 buckets are reused in a ring
+    // Each bucket is a min-heap of nodes so equal distances are visited lowest node first
+    std::vector<std::vector<int>> buckets(maxWeight + 1);
+    buckets[0].push_back(source);
+    size_t queued = 1;
+    for(int dist = 0; queued > 0; ++dist) {
+        std::vector<int>& bucket = buckets[dist % buckets.size()];
+        while(!bucket.empty()) {
+            std::pop_heap(bucket.begin(), bucket.end(), std::greater<int>());
+            int from = bucket.back();
+            bucket.pop_back();
+            --queued;
+            // A node is queued again each time its distance drops, later entries are stale
+            if(row[from].visited || row[from].dist != dist) continue;
+            row[from].visited = true;
+            this->forEachEdge(from, [this, row, from, &buckets, &queued](int to, int weight) {
+                if(!this->relax(row, from, to, weight)) return;
+                std::vector<int>& next = buckets[row[to].dist % buckets.size()];
+                next.push_back(to);
+                std::push_heap(next.begin(), next.end(), std::greater<int>());
+                ++queued;
+            });
         }
     }
 }
@@ -116,24 +325,24 @@ void GraphM::displayAll() const {
             if(i == j) continue;
             std::cout << "                               " << i+1 << "       " << j+1; 
             // If no path present
-            if(this->travel[i][j].dist == GraphM::NOPATH) {
+            if(this->trip(i, j).dist == GraphM::NOPATH) {
                 std::cout << "      " << "---" << "         ";
                 std::cout << i << std::endl;
                 continue;
             }
             // Formatting
-            if(this->travel[i][j].dist < 10) {
-                std::cout << "      " << this->travel[i][j].dist << "           ";
+            if(this->trip(i, j).dist < 10) {
+                std::cout << "      " << this->trip(i, j).dist << "           ";
             }
             else {
-                std::cout << "      " << this->travel[i][j].dist << "          ";
+                std::cout << "      " << this->trip(i, j).dist << "          ";
             }
             // Parse through path
-            int prev = this->travel[i][j].path;
+            int prev = this->trip(i, j).path;
             std::stack<int> path;
             while(prev != i) {
                 path.push(prev+1);
-                prev = this->travel[i][prev].path;
+                prev = this->trip(i, prev).path;
             }
             path.push(i+1);
             // Print path backwards
@@ -157,19 +366,19 @@ void GraphM::display(int from, int to) const {
     std::cout << "From " << *this->data[from-1] << " to " << *this->data[to-1] << "\n";
     // If no path was present
     std::stack<int> name;
-    if(this->travel[from-1][to-1].dist == GraphM::NOPATH) {
+    if(this->trip(from-1, to-1).dist == GraphM::NOPATH) {
         std::cout << "  " << "There is no path.\n";
 
         std::cout << std::endl;
         return;
     }
     // Otherwise print out of the path
-    std::cout << "      " << this->travel[from-1][to-1].dist << "          ";
-    int prev = this->travel[from-1][to-1].path;
+    std::cout << "      " << this->trip(from-1, to-1).dist << "          ";
+    int prev = this->trip(from-1, to-1).path;
     std::stack<int> path;
     while(prev != from-1) {
         path.push(prev+1);
-        prev = this->travel[from-1][prev].path;
+        prev = this->trip(from-1, prev).path;
     }
     path.push(from);
     name = path;
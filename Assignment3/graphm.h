@@ -4,21 +4,46 @@
  * @brief Header file for Matrix-implementation Graph
  * @version 0.1
  * @date 2022-05-01
- * 
+ *
  * @copyright Copyright (c) 2022
  */
 
 #pragma once
 
+#include<cstdint>
 #include<iostream>
+#include<vector>
 #include"nodedata.h"
 
+/**
+ * @brief Weighted directed graph with all-pairs shortest paths.
+ * @details
+ * The graph is sized by the number of nodes in its input. Edges are kept in one of two layouts,
+ * picked by how many edges the graph has:
+ *      dense graphs use a row-major size*size cost matrix
+ *      sparse graphs use compressed sparse rows, the edges of each node stored contiguously
+ * so a graph with 10^5 nodes and few edges per node takes memory in proportion to its edges.
+ */
 class GraphM{
 
-    private: 
+    public:
+
+    /**
+     * @brief How findShortestPath() picks the next node to visit from each source.
+     * @details
+     * Scan: linear scan of the table, O(V^2) per source, the fastest for dense graphs.
+     * Heap: binary heap, O(E log V) per source.
+     * Bucket: Dial's bucket queue, O(E + V + D) per source where D is the longest shortest path,
+     *      keeps one bucket per weight value, falls back to Heap if a weight is negative or above BUCKETLIMIT.
+     * Auto: Scan for the matrix layout, otherwise Bucket if every weight is in [0, BUCKETLIMIT], otherwise Heap.
+     * Every strategy visits nodes in the same order, ties going to the lower node, so the paths are identical.
+     */
+    enum class Search { Auto, Scan, Heap, Bucket };
 
-    static const int MAXNODES = 100;
-    static const int NOPATH = INT32_MAX;
+    private:
+
+    static constexpr int NOPATH = INT32_MAX;
+    static const int BUCKETLIMIT = 1024; // Largest weight the bucket queue is used for
 
     struct TableType {
         bool visited;          // whether node has been visited
@@ -26,23 +51,77 @@ class GraphM{
         int path;              // previous node in path of min dist
     };
 
-    NodeData* data[MAXNODES]; // data of nodes
-    int cost[MAXNODES][MAXNODES]; // cost adj. matrix
+    struct Edge {
+        int from;
+        int to;
+        int weight;
+    };
+
+    std::vector<NodeData*> data; // data of nodes
     int size; // number of nodes in graph
-    TableType travel[MAXNODES][MAXNODES]; // shortest path data
-    
+    bool dense; // true if the edges are in cost, false if they are in the sparse rows
+    std::vector<int> cost; // cost adj. matrix, size*size row-major, NOPATH if there is no edge
+    // Sparse rows, the edges from node i are targets[j], weights[j] for offsets[i] <= j < offsets[i+1]
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<int> weights; // NOPATH for a removed edge
+    std::vector<Edge> pending; // sparse edges inserted since the rows were last packed
+    std::vector<TableType> travel; // shortest path data, size*size row-major, empty until findShortestPath()
+    int single; // source of the only row in travel after findShortestPath(int), -1 if travel has every row
+
+    /**
+     * @brief Stores 'edges' in whichever layout is smaller for this graph.
+     * @details
+     * A later edge between the same two nodes replaces an earlier one.
+     * The matrix is used once it takes no more memory than the sparse rows would.
+     * @post pending is empty
+     */
+    void pack(std::vector<Edge>& edges);
+    /**
+     * @brief Merges pending edges into the sparse rows.
+     */
+    void flush();
+    /**
+     * @brief Returns the shortest path data from 'source' to 'to'.
+     * @details Every node is unreached from a source whose row has not been found.
+     */
+    const TableType& trip(int source, int to) const;
+    /**
+     * @brief Calls f(to, weight) for every edge leaving 'from', in either layout.
+     */
+    template<class F>
+    void forEachEdge(int from, F&& f) const;
+    /**
+     * @brief Lowers row[to] if the path through 'from' is cheaper.
+     * @return true If the distance was lowered.
+     */
+    bool relax(TableType* row, int from, int to, int weight) const;
+
+    /**
+     * @brief Replaces Auto, and Bucket if a weight is negative or above BUCKETLIMIT, with the strategy to run.
+     * @param maxWeight Receives the largest edge weight, at least zero.
+     */
+    Search resolve(Search, int& maxWeight) const;
+    /**
+     * @brief Runs one single-source search with 'search', filling 'row' with paths from 'source'.
+     * @pre 'row' holds size unreached entries.
+     */
+    void solve(TableType* row, int source, Search search, int maxWeight) const;
+
+    /* Single-source searches, each fills 'row' with the paths from 'source' */
+
+    void scanSearch(TableType* row, int source) const;
+    void heapSearch(TableType* row, int source) const;
+    void bucketSearch(TableType* row, int source, int maxWeight) const;
+
     public:
 
     /**
      * @brief Construct a new Graph
-     * @details 
-     * data is zero-initalized
-     * cost is initalized to NOPATH
+     * @details
+     * data is empty
      * size is zero-initalized
-     * travelInfo is initialized: 
-     *      dist to NOPATH
-     *      visited is zero-initalized
-     *      path is zero-initalized
+     * travel is empty, every node is unreached until findShortestPath()
      */
     GraphM();
     /**
@@ -52,12 +131,14 @@ class GraphM{
 
     /**
      * @brief Reads data from file and builds graph.
+     * @details The edges are collected first and packed once into the layout that fits them.
      * @param file File name to read information from.
      * @post Graph is constructed
      */
     void buildGraph(std::ifstream&);
     /**
      * @brief Inserts an edge between two nodes
+     * @details Replaces the weight of an existing edge between the nodes.
      * @param from from Node
      * @param to to Node
      * @param weight Weight of edge beteween nodes
@@ -65,16 +146,30 @@ class GraphM{
     void insertEdge(int, int, int);
     /**
      * @brief Removes an edge between two nodes
-     * @post Edge is set to -1
+     * @post Edge is set to NOPATH
      * @param from from Node
      * @param to to Node
      */
     void removeEdge(int, int);
     /**
      * @brief Finds the shortest path between every node to every other node.
-     * @post travelInfo is updated with shortest path information
+     * @details
+     * The table takes size*size entries, independent of the edge layout,
+     * use findShortestPath(int) for graphs too large to hold it.
+     * @param search Priority queue used by Dijkstra's algorithm, picked from the graph by default.
+     * @post travel is updated with shortest path information
      */
-    void findShortestPath();
+    void findShortestPath(Search = Search::Auto);
+    /**
+     * @brief Finds the shortest path from one node to every other node.
+     * @details
+     * Only the row of 'from' is kept, size entries, so display() and displayAll()
+     * show no path from any other node until the next search.
+     * @param from Node number, counted from 1 as in display()
+     * @param search Priority queue used by Dijkstra's algorithm, picked from the graph by default.
+     * @post travel holds the shortest paths from 'from', it is empty if 'from' is not in the graph
+     */
+    void findShortestPath(int, Search = Search::Auto);
     /**
      * @brief Displays all nodes in the graph
      */
@@ -85,4 +180,3 @@ class GraphM{
     void display(int, int) const;
 
 };
-
@@ -0,0 +1,188 @@
+#include"graphm.h"
+#include<cstdio>
+#include<fstream>
+#include<random>
+#include<sstream>
+#include<vector>
+
+using namespace std;
+
+const static int NODES = 40;
+
+struct TestEdge {
+	int from; // counted from 1, as in the data files
+	int to;
+	int weight;
+};
+
+void writeGraph(const string&, int, const vector<TestEdge>&);
+void loadGraph(GraphM&, int, const vector<TestEdge>&);
+vector<TestEdge> randomEdges(mt19937&, int, int, int);
+bool hasEdge(const vector<TestEdge>&, int, int);
+string displayAll(const GraphM&);
+string displayFrom(const GraphM&, int);
+
+int main() {
+	// Test Sparse Rows against the Matrix
+	// A graph built from every edge uses the matrix, removing most of them leaves it there
+	mt19937 rng(343);
+	vector<TestEdge> sparseEdges = randomEdges(rng, NODES, 80, 20);
+	vector<TestEdge> allEdges;
+	for(int from = 1; from <= NODES; ++from) {
+		for(int to = 1; to <= NODES; ++to) {
+			if(from != to) allEdges.push_back({from, to, 1});
+		}
+	}
+	allEdges.insert(allEdges.end(), sparseEdges.begin(), sparseEdges.end());
+	GraphM sparse, matrix;
+	loadGraph(sparse, NODES, sparseEdges);
+	loadGraph(matrix, NODES, allEdges);
+	for(int from = 1; from <= NODES; ++from) {
+		for(int to = 1; to <= NODES; ++to) {
+			if(!hasEdge(sparseEdges, from, to)) matrix.removeEdge(from-1, to-1);
+		}
+	}
+	sparse.findShortestPath();
+	matrix.findShortestPath();
+	string expected = displayAll(matrix);
+	displayAll(sparse) == expected ? cerr << "Sparse Rows Test Passed\n" : cerr << "Sparse Rows Test Failed\n";
+	cout << "---------------------------------------------------------------\n";
+	// Test Pending Edges are Merged into the Sparse Rows
+	// Half the edges are packed from the file, the rest are inserted afterwards
+	vector<TestEdge> firstHalf(sparseEdges.begin(), sparseEdges.begin() + sparseEdges.size() / 2);
+	GraphM pending;
+	loadGraph(pending, NODES, firstHalf);
+	for(size_t i = firstHalf.size(); i < sparseEdges.size(); ++i) {
+		pending.insertEdge(sparseEdges[i].from-1, sparseEdges[i].to-1, sparseEdges[i].weight);
+	}
+	// An edge inserted then removed before the search is never seen
+	int missing = 2;
+	while(hasEdge(sparseEdges, 1, missing)) ++missing;
+	pending.insertEdge(0, missing-1, 0);
+	pending.removeEdge(0, missing-1);
+	// An edge already in the rows is replaced in place, the last weight given to it is kept
+	TestEdge packed = firstHalf.front();
+	for(const TestEdge& edge : sparseEdges) {
+		if(edge.from == packed.from && edge.to == packed.to) packed.weight = edge.weight;
+	}
+	pending.insertEdge(packed.from-1, packed.to-1, 1000);
+	pending.insertEdge(packed.from-1, packed.to-1, packed.weight);
+	pending.findShortestPath();
+	displayAll(pending) == expected ? cerr << "Pending Edges Test Passed\n" : cerr << "Pending Edges Test Failed\n";
+	// Edges inserted after a search are used by the next one
+	GraphM later;
+	loadGraph(later, NODES, firstHalf);
+	later.findShortestPath();
+	for(size_t i = firstHalf.size(); i < sparseEdges.size(); ++i) {
+		later.insertEdge(sparseEdges[i].from-1, sparseEdges[i].to-1, sparseEdges[i].weight);
+	}
+	later.findShortestPath();
+	displayAll(later) == expected ? cerr << "Insert After Search Test Passed\n" : cerr << "Insert After Search Test Failed\n";
+	cout << "---------------------------------------------------------------\n";
+	// Test Scan, Heap and Bucket find the same paths
+	// Ties between equal paths go to the lower node in each strategy, so the output is identical
+	bool same = true;
+	for(int seed = 0; seed < 50; ++seed) {
+		mt19937 graphRng(seed);
+		int nodes = 2 + seed % 30;
+		int maxWeight = seed % 5 == 0 ? 3 : seed % 5 == 1 ? 2000 : 50;
+		GraphM graph;
+		loadGraph(graph, nodes, randomEdges(graphRng, nodes, nodes * 3, maxWeight));
+		graph.findShortestPath(GraphM::Search::Scan);
+		string scan = displayAll(graph);
+		graph.findShortestPath(GraphM::Search::Heap);
+		string heap = displayAll(graph);
+		graph.findShortestPath(GraphM::Search::Bucket);
+		string bucket = displayAll(graph);
+		graph.findShortestPath();
+		string chosen = displayAll(graph);
+		if(heap != scan || bucket != scan || chosen != scan) same = false;
+	}
+	same ? cerr << "Search Strategies Test Passed\n" : cerr << "Search Strategies Test Failed\n";
+	// A weight too large for one bucket per distance sends Bucket to the heap
+	GraphM heavy;
+	loadGraph(heavy, 4, {{1, 2, 2000000000}, {1, 3, 5}, {3, 4, 7}, {4, 2, 1}});
+	heavy.findShortestPath(GraphM::Search::Scan);
+	string heavyScan = displayAll(heavy);
+	heavy.findShortestPath(GraphM::Search::Heap);
+	string heavyHeap = displayAll(heavy);
+	heavy.findShortestPath(GraphM::Search::Bucket);
+	string heavyBucket = displayAll(heavy);
+	heavyBucket == heavyScan && heavyHeap == heavyScan ? cerr << "Large Weight Bucket Test Passed\n" : cerr << "Large Weight Bucket Test Failed\n";
+	cout << "---------------------------------------------------------------\n";
+	// Test One Source at a Time
+	bool sourceRows = true;
+	for(int from = 1; from <= NODES; ++from) {
+		sparse.findShortestPath(from);
+		if(displayFrom(sparse, from) != displayFrom(matrix, from)) sourceRows = false;
+	}
+	sourceRows ? cerr << "Single Source Test Passed\n" : cerr << "Single Source Test Failed\n";
+	// Other rows are not kept, and a node outside the graph finds nothing
+	sparse.findShortestPath(1);
+	string other = displayFrom(sparse, 2);
+	sparse.findShortestPath(NODES + 1);
+	string outside = displayFrom(sparse, 1);
+	GraphM unreached;
+	loadGraph(unreached, NODES, {});
+	unreached.findShortestPath(1);
+	other == displayFrom(unreached, 2) && outside == displayFrom(unreached, 1) ? cerr << "Single Source Rows Test Passed\n" : cerr << "Single Source Rows Test Failed\n";
+	cout << "---------------------------------------------------------------\n";
+}
+
+void writeGraph(const string& file, int nodes, const vector<TestEdge>& edges) {
+	ofstream out(file);
+	out << nodes << '\n';
+	for(int i = 1; i <= nodes; ++i) {
+		out << "Node " << i << '\n';
+	}
+	for(const TestEdge& edge : edges) {
+		out << edge.from << ' ' << edge.to << ' ' << edge.weight << '\n';
+	}
+	out << "0 0 0\n";
+}
+
+void loadGraph(GraphM& graph, int nodes, const vector<TestEdge>& edges) {
+	writeGraph("testGraph.txt", nodes, edges);
+	ifstream infile("testGraph.txt");
+	graph.buildGraph(infile);
+	infile.close();
+	remove("testGraph.txt");
+}
+
+vector<TestEdge> randomEdges(mt19937& rng, int nodes, int count, int maxWeight) {
+	uniform_int_distribution<int> node(1, nodes);
+	uniform_int_distribution<int> weight(0, maxWeight);
+	vector<TestEdge> edges;
+	for(int i = 0; i < count; ++i) {
+		int from = node(rng);
+		int to = node(rng);
+		if(from != to) edges.push_back({from, to, weight(rng)});
+	}
+	return edges;
+}
+
+bool hasEdge(const vector<TestEdge>& edges, int from, int to) {
+	for(const TestEdge& edge : edges) {
+		if(edge.from == from && edge.to == to) return true;
+	}
+	return false;
+}
+
+string displayAll(const GraphM& graph) {
+	ostringstream out;
+	streambuf* console = cout.rdbuf(out.rdbuf());
+	graph.displayAll();
+	cout.rdbuf(console);
+	return out.str();
+}
+
+string displayFrom(const GraphM& graph, int from) {
+	ostringstream out;
+	streambuf* console = cout.rdbuf(out.rdbuf());
+	// display() is only given distinct nodes
+	for(int to = 1; to <= NODES; ++to) {
+		if(to != from) graph.display(from, to);
+	}
+	cout.rdbuf(console);
+	return out.str();
+}
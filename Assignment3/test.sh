@@ -0,0 +1 @@
+g++ graphm.cpp nodedata.cpp test.cpp -g -std=c++17 -o Test.out && ./Test.out && rm Test.out
\ No newline at end of file